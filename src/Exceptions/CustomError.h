@@ -38,7 +38,7 @@ public:
     const char * what() const noexcept override ;
 
 private:
-    const string& message; /**< Custom error message >**/
+    string message; /**< Custom error message >**/
     ERROR_TYPE type; /**< Error type >**/
 
 };
@@ -0,0 +1,970 @@
+/**
+ * @file BranchBound.cpp
+ * @brief Implementation of the branch and bound search
+ */
+
+/**< Project headers >**/
+#include "BranchBound.h"
+#include "ThreadPool.h"
+#include "../Exceptions/CustomError.h"
+
+/**< STD headers >**/
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+BranchBound::BranchBound(const DistanceMatrix& _matrix, BOUND_TYPE _bound) : matrix(_matrix), bound(_bound) {
+    n = matrix.size();
+    symmetric = matrix.isSymmetric();
+    nearest.resize(n);
+    for (int i = 0; i < n; i++) {
+        const double* row = matrix.row(i);
+        for (int j = 0; j < n; j++) {
+            if (j != i) {
+                nearest[i].push_back(j);
+            }
+        }
+        stable_sort(nearest[i].begin(), nearest[i].end(), [row](int a, int b) { return row[a] < row[b]; });
+    }
+}
+
+unsigned long long BranchBound::getNodes() const {
+    unsigned long long nodes = base_nodes;
+    for (const auto& worker : workers) {
+        nodes += worker->nodes.load(memory_order_relaxed);
+    }
+    return nodes;
+}
+
+vector<unsigned long long> BranchBound::getThreadNodes() const {
+    vector<unsigned long long> nodes;
+    for (const auto& worker : workers) {
+        nodes.push_back(worker->nodes.load(memory_order_relaxed));
+    }
+    return nodes;
+}
+
+void BranchBound::prepare(int threads) {
+    workers.clear();
+    for (int i = 0; i < threads; i++) {
+        auto worker = make_unique<Worker>();
+        worker->visited.assign(n, false);
+        worker->path.reserve(n);
+        worker->left.reserve(n);
+        worker->key.resize(n);
+        worker->reduce.resize(n);
+        worker->way.resize(n);
+        worker->used.resize(n);
+        worker->id = i;
+        workers.push_back(std::move(worker));
+    }
+    best = DistanceMatrix::INF;
+    lower_bound = 0;
+    best_path.clear();
+    base_nodes = 0;
+    if (resuming) {
+        best = resume.best;
+        best_path = resume.best_path;
+        lower_bound = resume.lower_bound;
+        base_nodes = resume.nodes;
+    }
+    pending = 0;
+    idle = 0;
+    frontier.clear();
+    stopped = false;
+    started = chrono::steady_clock::now();
+    next_report = progress_period;
+}
+
+vector<BranchBound::Subtree> BranchBound::startingSubtrees() {
+    if (!resuming) {
+        // The bound of the root is the first lower bound of the optimum
+        Subtree root = {{0}, 0};
+        Worker& worker = *workers[0];
+        enter(worker, root);
+        lower_bound = lowerBound(worker, 0);
+        leave(worker, root);
+        return {root};
+    }
+    resuming = false;
+    return std::move(resume.frontier);
+}
+
+void BranchBound::searchSubtrees(const vector<Subtree>& subtrees) {
+    Worker& worker = *workers[0];
+    for (const Subtree& subtree : subtrees) {
+        enter(worker, subtree);
+        search(worker, subtree.path.back(), subtree.cost);
+        leave(worker, subtree);
+    }
+}
+
+double BranchBound::finish(vector<int>& order) {
+    // Subtrees that can't beat the incumbent any more are not work left
+    Worker& worker = *workers[0];
+    double frontier_bound = DistanceMatrix::INF;
+    vector<Subtree> left;
+    for (Subtree& subtree : frontier) {
+        if (subtree.bound == -DistanceMatrix::INF) {
+            enter(worker, subtree);
+            subtree.bound = subtree.cost + lowerBound(worker, subtree.path.back());
+            leave(worker, subtree);
+        }
+        if (!pruned(subtree.bound)) {
+            frontier_bound = min(frontier_bound, subtree.bound);
+            left.push_back(std::move(subtree));
+        }
+    }
+    frontier = std::move(left);
+
+    if (frontier.empty()) {
+        lower_bound = best.load();
+    }
+    else {
+        lower_bound = max(lower_bound.load(), min(frontier_bound, best.load()));
+    }
+    order = best_path;
+    return best;
+}
+
+void BranchBound::enter(Worker& worker, const Subtree& subtree) {
+    for (int v : subtree.path) {
+        worker.visited[v] = true;
+    }
+    worker.path = subtree.path;
+}
+
+void BranchBound::leave(Worker& worker, const Subtree& subtree) {
+    for (int v : subtree.path) {
+        worker.visited[v] = false;
+    }
+    worker.path.clear();
+}
+
+void BranchBound::count(Worker& worker, size_t open) {
+    unsigned long long nodes = worker.nodes.load(memory_order_relaxed) + 1;
+    worker.nodes.store(nodes, memory_order_relaxed);
+    if ((nodes & (POLL_NODES - 1)) != 0) {
+        return;
+    }
+    if (time_limit > 0 && chrono::duration<double>(chrono::steady_clock::now() - started).count() >= time_limit) {
+        stopped = true;
+    }
+    report(open);
+}
+
+void BranchBound::keep(const vector<int>& path, double cost, double bound) {
+    lock_guard<mutex> guard(frontier_lock);
+    frontier.push_back({path, cost, bound});
+}
+
+bool BranchBound::isComplete() const {
+    return frontier.empty();
+}
+
+void BranchBound::setProgress(ProgressCallback callback, double period) {
+    progress = std::move(callback);
+    progress_period = max(period, 0.0);
+}
+
+void BranchBound::setTimeLimit(double seconds) {
+    time_limit = max(seconds, 0.0);
+}
+
+double BranchBound::getLowerBound() const {
+    return lower_bound;
+}
+
+void BranchBound::report(size_t open) {
+    if (!progress) {
+        return;
+    }
+    // A thread that finds another one reporting skips its turn
+    unique_lock<mutex> guard(report_lock, try_to_lock);
+    if (!guard.owns_lock()) {
+        return;
+    }
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    if (elapsed < next_report) {
+        return;
+    }
+    next_report = elapsed + progress_period;
+    unsigned long long nodes = getNodes();
+    double rate = elapsed > 0 ? static_cast<double>(nodes - base_nodes) / elapsed : 0;
+    progress({best, lower_bound, nodes, open, elapsed, rate});
+}
+
+void BranchBound::saveCheckpoint(const string& path) const {
+    string temporary = path + ".tmp";
+    ofstream file(temporary, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        throw CustomError("Could not write the checkpoint " + temporary, FILE_ERROR);
+    }
+    auto put = [&file](const auto& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    auto putPath = [&file, &put](const vector<int>& ids) {
+        put(static_cast<uint32_t>(ids.size()));
+        for (int id : ids) {
+            put(static_cast<uint32_t>(id));
+        }
+    };
+
+    file.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    put(CHECKPOINT_VERSION);
+    put(static_cast<uint32_t>(n));
+    put(matrix.getChecksum());
+    put(static_cast<uint64_t>(getNodes()));
+    put(lower_bound.load());
+    put(best.load());
+    putPath(best_path);
+    put(static_cast<uint64_t>(frontier.size()));
+    for (const Subtree& subtree : frontier) {
+        put(subtree.cost);
+        putPath(subtree.path);
+    }
+    file.close();
+    if (file.fail()) {
+        throw CustomError("Could not write the checkpoint " + temporary, FILE_ERROR);
+    }
+
+    error_code error;
+    filesystem::rename(temporary, path, error);
+    if (error) {
+        throw CustomError("Could not replace the checkpoint " + path + ": " + error.message(), FILE_ERROR);
+    }
+}
+
+void BranchBound::loadCheckpoint(const string& path) {
+    ifstream file(path, ios::binary);
+    if (!file.is_open()) {
+        throw CustomError("Could not open the checkpoint " + path, FILE_ERROR);
+    }
+    auto get = [&file](auto& value) {
+        file.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return !file.fail();
+    };
+    // A path must start at 0 and visit distinct vertices
+    auto getPath = [&](vector<int>& ids) {
+        uint32_t length;
+        if (!get(length) || length > static_cast<uint32_t>(n)) {
+            return false;
+        }
+        vector<char> seen(n, false);
+        ids.resize(length);
+        for (uint32_t i = 0; i < length; i++) {
+            uint32_t id;
+            if (!get(id) || id >= static_cast<uint32_t>(n) || seen[id]) {
+                return false;
+            }
+            seen[id] = true;
+            ids[i] = static_cast<int>(id);
+        }
+        return length == 0 || ids[0] == 0;
+    };
+
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    uint32_t version, size;
+    uint64_t checksum, nodes, subtrees;
+    Checkpoint loaded;
+    file.read(magic, sizeof(magic));
+    if (file.fail() || !equal(magic, magic + sizeof(magic), CHECKPOINT_MAGIC) || !get(version) ||
+        version != CHECKPOINT_VERSION) {
+        throw CustomError("Not a checkpoint file: " + path, FILE_ERROR);
+    }
+    if (!get(size) || size != static_cast<uint32_t>(n) || !get(checksum) || checksum != matrix.getChecksum()) {
+        throw CustomError("The checkpoint " + path + " was saved for another graph", FILE_ERROR);
+    }
+    bool valid = get(nodes) && get(loaded.lower_bound) && get(loaded.best) && getPath(loaded.best_path) &&
+                 (loaded.best_path.empty() || static_cast<int>(loaded.best_path.size()) == n) && get(subtrees);
+    for (uint64_t i = 0; valid && i < subtrees; i++) {
+        Subtree subtree;
+        valid = get(subtree.cost) && getPath(subtree.path) && !subtree.path.empty();
+        loaded.frontier.push_back(std::move(subtree));
+    }
+    if (!valid) {
+        throw CustomError("Corrupted checkpoint " + path, FILE_ERROR);
+    }
+    loaded.nodes = nodes;
+    resume = std::move(loaded);
+    resuming = true;
+}
+
+double BranchBound::solve(vector<int>& order) {
+    parallel = false;
+    prepare(1);
+    order.clear();
+    if (n == 0) {
+        return best;
+    }
+
+    seedIncumbent();
+    searchSubtrees(startingSubtrees());
+    return finish(order);
+}
+
+double BranchBound::parallelSolve(vector<int>& order, int threads) {
+    parallel = true;
+    threads = max(threads, 1);
+    prepare(threads);
+    order.clear();
+    if (n == 0) {
+        return best;
+    }
+
+    seedIncumbent();
+
+    // The whole tree (or the saved frontier) is the first work, idle threads make it split
+    vector<Subtree> subtrees = startingSubtrees();
+    pending = static_cast<long long>(subtrees.size());
+    for (auto it = subtrees.rbegin(); it != subtrees.rend(); ++it) {
+        workers[0]->subtrees.push_back(std::move(*it));
+    }
+    ThreadPool pool(threads);
+    pool.parallelFor(0, threads, 1, [this](size_t id, size_t, int) {
+        work(static_cast<int>(id));
+    });
+
+    return finish(order);
+}
+
+double BranchBound::bestFirstSolve(vector<int>& order, size_t memory_cap) {
+    parallel = false;
+    prepare(1);
+    order.clear();
+    if (n == 0) {
+        return best;
+    }
+
+    seedIncumbent();
+
+    vector<Subtree> starts = startingSubtrees();
+    if (n > 64) {
+        searchSubtrees(starts);
+        return finish(order);
+    }
+
+    // Open records are a binary heap of indices into the records (lowest bound first, deeper first on ties)
+    Worker& worker = *workers[0];
+    vector<Node> nodes;
+    vector<uint32_t> open;
+    size_t max_nodes = min(memory_cap / (sizeof(Node) + sizeof(uint32_t)), static_cast<size_t>(NO_PARENT));
+    auto after = [&nodes](uint32_t a, uint32_t b) {
+        return nodes[a].bound > nodes[b].bound || (nodes[a].bound == nodes[b].bound && nodes[a].depth < nodes[b].depth);
+    };
+    // Grows both vectors by hand so that the cap is never passed by a reallocation
+    auto reserve = [&](size_t extra) {
+        size_t needed = nodes.size() + extra;
+        if (needed <= nodes.capacity()) {
+            return true;
+        }
+        size_t capacity = min(max({nodes.capacity() * 2, needed, size_t(1024)}), max_nodes);
+        if (capacity < needed) {
+            return false;
+        }
+        nodes.reserve(capacity);
+        open.reserve(capacity);
+        return true;
+    };
+
+    // Each start is a chain of records (one per vertex of its path), only the last one is open
+    bool capped = false;
+    for (const Subtree& subtree : starts) {
+        enter(worker, subtree);
+        size_t length = subtree.path.size();
+        if (!capped && !reserve(length)) {
+            capped = true;
+        }
+        if (capped) {
+            search(worker, subtree.path.back(), subtree.cost);
+        }
+        else {
+            double start_bound = subtree.cost + lowerBound(worker, subtree.path.back());
+            uint64_t mask = 0;
+            double cost = 0;
+            uint32_t parent = NO_PARENT;
+            for (size_t i = 0; i < length; i++) {
+                int v = subtree.path[i];
+                cost += i > 0 ? matrix.get(subtree.path[i - 1], v) : 0;
+                mask |= uint64_t(1) << v;
+                nodes.push_back({mask, cost, start_bound, parent, static_cast<uint8_t>(v),
+                                 static_cast<uint8_t>(i + 1)});
+                parent = static_cast<uint32_t>(nodes.size() - 1);
+            }
+            open.push_back(parent);
+            push_heap(open.begin(), open.end(), after);
+        }
+        leave(worker, subtree);
+    }
+
+    while (!open.empty()) {
+        pop_heap(open.begin(), open.end(), after);
+        uint32_t index = open.back();
+        open.pop_back();
+        Node node = nodes[index];
+
+        if (stopped) {
+            // Deadline, the open records that can still beat the incumbent become the frontier
+            open.push_back(index);
+            for (uint32_t left : open) {
+                if (!pruned(nodes[left].bound)) {
+                    pathOf(nodes, left, worker.path);
+                    keep(worker.path, nodes[left].cost, nodes[left].bound);
+                }
+            }
+            break;
+        }
+
+        // Every open node has a bound at least as high as this one
+        lower_bound = max(lower_bound.load(), min(node.bound, best.load()));
+        if (pruned(node.bound)) {
+            break;
+        }
+        if (!capped && !reserve(n)) {
+            capped = true;
+        }
+
+        for (int v = 0; v < n; v++) {
+            worker.visited[v] = (node.mask >> v) & 1;
+        }
+        pathOf(nodes, index, worker.path);
+        if (bound == ASSIGNMENT && !capped) {
+            // Solved once for the node so that every child starts from it
+            lowerBound(worker, node.last);
+        }
+
+        if (capped) {
+            // Out of memory for records, the open nodes are finished depth first
+            search(worker, node.last, node.cost);
+        }
+        else {
+            count(worker, open.size());
+            for (int next : nearest[node.last]) {
+                if (worker.visited[next]) {
+                    continue;
+                }
+                double cost = node.cost + matrix.get(node.last, next);
+                if (pruned(cost)) {
+                    break;
+                }
+                if (rejected(worker, next)) {
+                    continue;
+                }
+                if (node.depth + 1 == n) {
+                    double total = cost + matrix.get(next, 0);
+                    if (total != DistanceMatrix::INF) {
+                        worker.path.push_back(next);
+                        offer(worker.path, total);
+                        worker.path.pop_back();
+                    }
+                    continue;
+                }
+                worker.visited[next] = true;
+                double child_bound = cost + lowerBound(worker, next);
+                worker.visited[next] = false;
+                if (!pruned(child_bound)) {
+                    nodes.push_back({node.mask | (uint64_t(1) << next), cost, child_bound, index,
+                                     static_cast<uint8_t>(next), static_cast<uint8_t>(node.depth + 1)});
+                    open.push_back(static_cast<uint32_t>(nodes.size() - 1));
+                    push_heap(open.begin(), open.end(), after);
+                }
+            }
+        }
+    }
+    fill(worker.visited.begin(), worker.visited.end(), false);
+
+    return finish(order);
+}
+
+void BranchBound::pathOf(const vector<Node>& nodes, uint32_t index, vector<int>& path) {
+    path.clear();
+    for (uint32_t i = index; i != NO_PARENT; i = nodes[i].parent) {
+        path.push_back(nodes[i].last);
+    }
+    reverse(path.begin(), path.end());
+}
+
+void BranchBound::work(int id) {
+    Worker& worker = *workers[id];
+    Subtree subtree;
+    bool waiting = false;
+    while (true) {
+        if (take(id, subtree)) {
+            if (waiting) {
+                idle--;
+                waiting = false;
+            }
+            enter(worker, subtree);
+            search(worker, subtree.path.back(), subtree.cost);
+            leave(worker, subtree);
+            pending--;
+            continue;
+        }
+        if (pending == 0) {
+            break;
+        }
+        if (!waiting) {
+            idle++;
+            waiting = true;
+        }
+        this_thread::yield();
+    }
+    if (waiting) {
+        idle--;
+    }
+}
+
+bool BranchBound::take(int id, Subtree& subtree) {
+    {
+        Worker& own = *workers[id];
+        lock_guard<mutex> guard(own.lock);
+        if (!own.subtrees.empty()) {
+            subtree = std::move(own.subtrees.back());
+            own.subtrees.pop_back();
+            return true;
+        }
+    }
+    int threads = static_cast<int>(workers.size());
+    for (int i = 1; i < threads; i++) {
+        Worker& victim = *workers[(id + i) % threads];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.subtrees.empty()) {
+            subtree = std::move(victim.subtrees.front());
+            victim.subtrees.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BranchBound::rejected(const Worker& worker, int next) const {
+    // Symmetric tours are searched in one direction only: vertex 1 before vertex 2
+    if (symmetric && next == 2 && !worker.visited[1]) {
+        return true;
+    }
+    return matrix.isDominated(worker.path.data(), static_cast<int>(worker.path.size()), next, symmetric);
+}
+
+bool BranchBound::pruned(double value) const {
+    double incumbent = best.load(memory_order_relaxed);
+    if (!parallel) {
+        return value >= incumbent;
+    }
+    // Ties are kept so every optimal tour is reached and the smallest one wins
+    return value == DistanceMatrix::INF || value > incumbent + incumbent * TIE_TOLERANCE;
+}
+
+void BranchBound::offer(const vector<int>& path, double cost) {
+    lock_guard<mutex> guard(incumbent_lock);
+    double incumbent = best.load(memory_order_relaxed);
+    if (cost < incumbent || (parallel && cost == incumbent && path < best_path)) {
+        best.store(cost, memory_order_relaxed);
+        best_path = path;
+    }
+}
+
+void BranchBound::search(Worker& worker, int current, double cost) {
+    vector<int>& path = worker.path;
+    if (stopped.load(memory_order_relaxed)) {
+        keep(path, cost);
+        return;
+    }
+    count(worker, parallel ? static_cast<size_t>(max(pending.load(memory_order_relaxed), 0LL)) : 0);
+    if (static_cast<int>(path.size()) == n) {
+        double total = cost + matrix.get(current, 0);
+        if (total != DistanceMatrix::INF) {
+            offer(path, total);
+        }
+        return;
+    }
+    if (pruned(cost + lowerBound(worker, current))) {
+        return;
+    }
+    if (parallel && idle.load(memory_order_relaxed) > 0 && n - static_cast<int>(path.size()) > SPLIT_MIN) {
+        split(worker, current, cost);
+        return;
+    }
+
+    // Nearest first, the first child that can't beat the incumbent ends the loop (the others are farther)
+    for (int next : nearest[current]) {
+        if (worker.visited[next]) {
+            continue;
+        }
+        double distance = matrix.get(current, next);
+        if (pruned(cost + distance)) {
+            break;
+        }
+        if (rejected(worker, next)) {
+            continue;
+        }
+        worker.visited[next] = true;
+        path.push_back(next);
+        search(worker, next, cost + distance);
+        path.pop_back();
+        worker.visited[next] = false;
+    }
+}
+
+void BranchBound::split(Worker& worker, int current, double cost) {
+    vector<Subtree> children;
+    for (int next : nearest[current]) {
+        if (worker.visited[next]) {
+            continue;
+        }
+        double distance = matrix.get(current, next);
+        if (pruned(cost + distance)) {
+            break;
+        }
+        if (rejected(worker, next)) {
+            continue;
+        }
+        vector<int> path = worker.path;
+        path.push_back(next);
+        children.push_back({std::move(path), cost + distance});
+    }
+    pending += static_cast<long long>(children.size());
+    lock_guard<mutex> guard(worker.lock);
+    for (auto it = children.rbegin(); it != children.rend(); ++it) {
+        worker.subtrees.push_back(std::move(*it));
+    }
+}
+
+void BranchBound::seedIncumbent() {
+    // Nearest neighbour
+    vector<char> in_tour(n, false);
+    vector<int> tour = {0};
+    in_tour[0] = true;
+    int current = 0;
+    while (static_cast<int>(tour.size()) < n) {
+        int chosen = -1;
+        for (int next : nearest[current]) {
+            if (!in_tour[next]) {
+                if (matrix.get(current, next) != DistanceMatrix::INF) {
+                    chosen = next;
+                }
+                break;
+            }
+        }
+        if (chosen == -1) {
+            return;
+        }
+        in_tour[chosen] = true;
+        tour.push_back(chosen);
+        current = chosen;
+    }
+
+    // 2-opt, reversing a segment only keeps the cost of the other edges when the matrix is symmetric
+    bool improved = symmetric;
+    while (improved) {
+        improved = false;
+        for (int i = 0; i < n - 2; i++) {
+            for (int j = i + 2; j < n; j++) {
+                int a = tour[i], b = tour[i + 1], c = tour[j], d = tour[(j + 1) % n];
+                if (a == d) {
+                    continue;
+                }
+                double delta = matrix.get(a, c) + matrix.get(b, d) - matrix.get(a, b) - matrix.get(c, d);
+                if (delta < -1e-9) {
+                    reverse(tour.begin() + i + 1, tour.begin() + j + 1);
+                    improved = true;
+                }
+            }
+        }
+    }
+
+    double cost = matrix.tourCost(tour);
+    if (cost != DistanceMatrix::INF) {
+        offer(tour, cost);
+    }
+}
+
+double BranchBound::lowerBound(Worker& worker, int current) {
+    vector<int>& left = worker.left;
+    left.clear();
+    for (int v = 0; v < n; v++) {
+        if (!worker.visited[v]) {
+            left.push_back(v);
+        }
+    }
+    if (left.empty()) {
+        return matrix.get(current, 0);
+    }
+
+    switch (bound) {
+        case TWO_EDGES:
+            return twoEdgesBound(worker, current);
+        case ONE_TREE:
+            return oneTreeBound(worker, current);
+        case REDUCED_MATRIX:
+            return reducedMatrixBound(worker, current);
+        case ASSIGNMENT:
+            return assignmentBound(worker, current);
+    }
+    return 0;
+}
+
+double BranchBound::twoEdgesBound(Worker& worker, int current) {
+    const vector<int>& left = worker.left;
+    const double INF = DistanceMatrix::INF;
+    double first_edge = INF, last_edge = INF;
+    for (int u : left) {
+        first_edge = min(first_edge, matrix.get(current, u));
+        last_edge = min(last_edge, matrix.get(u, 0));
+    }
+
+    if (symmetric) {
+        double sum = first_edge + last_edge;
+        for (int v : left) {
+            const double* row = matrix.row(v);
+            double first = min(row[current], row[0]), second = max(row[current], row[0]);
+            for (int u : left) {
+                if (u == v) {
+                    continue;
+                }
+                if (row[u] < first) {
+                    second = first;
+                    first = row[u];
+                }
+                else if (row[u] < second) {
+                    second = row[u];
+                }
+            }
+            sum += first + second;
+        }
+        return sum / 2;
+    }
+
+    // Asymmetric: every vertex left is entered once and left once, so both sums are lower bounds
+    double out_sum = first_edge, in_sum = last_edge;
+    for (int v : left) {
+        double out = matrix.get(v, 0), in = matrix.get(current, v);
+        for (int u : left) {
+            if (u != v) {
+                out = min(out, matrix.get(v, u));
+                in = min(in, matrix.get(u, v));
+            }
+        }
+        out_sum += out;
+        in_sum += in;
+    }
+    return max(out_sum, in_sum);
+}
+
+double BranchBound::oneTreeBound(Worker& worker, int current) {
+    vector<int>& left = worker.left;
+    vector<double>& key = worker.key;
+    const double INF = DistanceMatrix::INF;
+    double first_edge = INF, last_edge = INF;
+    for (int u : left) {
+        first_edge = min(first_edge, matrix.get(current, u));
+        last_edge = min(last_edge, matrix.get(u, 0));
+        key[u] = INF;
+    }
+
+    // Dense Prim over the vertices left, an edge can be used in its cheapest direction
+    double tree = 0;
+    size_t k = left.size();
+    key[left[0]] = 0;
+    for (size_t added = 0; added < k; added++) {
+        size_t chosen = added;
+        for (size_t i = added + 1; i < k; i++) {
+            if (key[left[i]] < key[left[chosen]]) {
+                chosen = i;
+            }
+        }
+        swap(left[added], left[chosen]);
+        int v = left[added];
+        tree += key[v];
+        if (tree == INF) {
+            return INF;
+        }
+        for (size_t i = added + 1; i < k; i++) {
+            int u = left[i];
+            key[u] = min(key[u], min(matrix.get(v, u), matrix.get(u, v)));
+        }
+    }
+    return first_edge + tree + last_edge;
+}
+
+double BranchBound::reducedMatrixBound(Worker& worker, int current) {
+    const vector<int>& left = worker.left;
+    vector<double>& reduce = worker.reduce;
+    const double INF = DistanceMatrix::INF;
+    // Rows: current and the vertices left, columns: the vertices left and the start
+    // current -> start is forbidden while vertices are left
+    double sum = 0;
+    auto rowCost = [&](int i, int j) {
+        return (i == j || (i == current && j == 0)) ? INF : matrix.get(i, j);
+    };
+
+    reduce[current] = INF;
+    for (int j : left) {
+        reduce[current] = min(reduce[current], rowCost(current, j));
+    }
+    sum += reduce[current];
+    for (int i : left) {
+        reduce[i] = rowCost(i, 0);
+        for (int j : left) {
+            reduce[i] = min(reduce[i], rowCost(i, j));
+        }
+        sum += reduce[i];
+    }
+    if (sum == INF) {
+        return INF;
+    }
+
+    auto columnMin = [&](int j) {
+        double column = rowCost(current, j) - reduce[current];
+        for (int i : left) {
+            column = min(column, rowCost(i, j) - reduce[i]);
+        }
+        return column;
+    };
+    for (int j : left) {
+        sum += columnMin(j);
+    }
+    sum += columnMin(0);
+    return sum;
+}
+
+/**
+ * @brief Cost of assigning row i to column j, a vertex can't follow itself and current can't go back to the start
+ * while vertices are left
+ */
+static double assignmentCost(const DistanceMatrix& matrix, int current, int i, int j) {
+    return (i == j || (i == current && j == 0)) ? DistanceMatrix::INF : matrix.get(i, j);
+}
+
+double BranchBound::assignmentBound(Worker& worker, int current) {
+    vector<int>& columns = worker.left;
+    int depth = n - static_cast<int>(columns.size());
+    if (static_cast<int>(worker.assignments.size()) <= depth) {
+        worker.assignments.resize(depth + 1);
+    }
+    Assignment& state = worker.assignments[depth];
+
+    if (isParentAssignment(worker, worker.assignments[depth - 1], current)) {
+        // The parent row and column current leave the problem, current -> start becomes forbidden. The potentials stay
+        // feasible, so only the rows left without a column need an augmenting path
+        state = worker.assignments[depth - 1];
+        int previous = state.current;
+        state.current = current;
+        state.row[state.column[previous]] = -1;
+        state.column[previous] = -1;
+        if (state.row[current] != -1) {
+            state.column[state.row[current]] = -1;
+            state.row[current] = -1;
+        }
+        if (state.column[current] == 0) {
+            state.column[current] = -1;
+            state.row[0] = -1;
+        }
+    }
+    else {
+        state.current = current;
+        state.column.assign(n, -1);
+        state.row.assign(n, -1);
+        state.u.assign(n, 0);
+        state.v.assign(n, 0);
+    }
+
+    // Rows: current and the vertices left, columns: the vertices left and the start
+    size_t k = columns.size();
+    columns.push_back(0);
+    bool feasible = state.column[current] != -1 || augment(worker, state, current);
+    for (size_t i = 0; feasible && i < k; i++) {
+        if (state.column[columns[i]] == -1) {
+            feasible = augment(worker, state, columns[i]);
+        }
+    }
+    columns.pop_back();
+    if (!feasible) {
+        state.current = -1;
+        return DistanceMatrix::INF;
+    }
+
+    double sum = assignmentCost(matrix, current, current, state.column[current]);
+    for (size_t i = 0; i < k; i++) {
+        sum += assignmentCost(matrix, current, columns[i], state.column[columns[i]]);
+    }
+    return sum;
+}
+
+bool BranchBound::isParentAssignment(const Worker& worker, const Assignment& parent, int current) const {
+    int previous = parent.current;
+    if (previous == -1 || previous == current || !worker.visited[previous]) {
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        bool is_row = i == previous || i == current || !worker.visited[i];
+        bool is_column = i == current || i == 0 || !worker.visited[i];
+        if ((parent.column[i] != -1) != is_row || (parent.row[i] != -1) != is_column) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BranchBound::augment(Worker& worker, Assignment& state, int free_row) {
+    const vector<int>& columns = worker.left;
+    vector<double>& slack = worker.key;
+    vector<int>& way = worker.way;
+    vector<char>& used = worker.used;
+    const double INF = DistanceMatrix::INF;
+    for (int j : columns) {
+        slack[j] = INF;
+        way[j] = -1;
+        used[j] = false;
+    }
+
+    // Dijkstra over the reduced costs from the free row (column -1), until a free column is reached
+    int row = free_row, column = -1;
+    while (true) {
+        double delta = INF;
+        int next = -1;
+        for (int j : columns) {
+            if (used[j]) {
+                continue;
+            }
+            double reduced = assignmentCost(matrix, state.current, row, j) - state.u[row] - state.v[j];
+            if (reduced < slack[j]) {
+                slack[j] = reduced;
+                way[j] = column;
+            }
+            if (slack[j] < delta) {
+                delta = slack[j];
+                next = j;
+            }
+        }
+        if (next == -1) {
+            return false;
+        }
+        state.u[free_row] += delta;
+        for (int j : columns) {
+            if (used[j]) {
+                state.u[state.row[j]] += delta;
+                state.v[j] -= delta;
+            }
+            else {
+                slack[j] -= delta;
+            }
+        }
+        used[next] = true;
+        column = next;
+        if (state.row[column] == -1) {
+            break;
+        }
+        row = state.row[column];
+    }
+
+    // Every row on the path moves to the next column
+    while (column != -1) {
+        int previous = way[column];
+        int moved = (previous == -1) ? free_row : state.row[previous];
+        state.row[column] = moved;
+        state.column[moved] = column;
+        column = previous;
+    }
+    return true;
+}
@@ -0,0 +1,463 @@
+#ifndef TSP_ANALYSIS_BRANCHBOUND_H
+#define TSP_ANALYSIS_BRANCHBOUND_H
+
+/**
+ * @file BranchBound.h
+ * @brief Header for the branch and bound search over a distance matrix
+ */
+
+/**< Project headers >**/
+#include "../model/DistanceMatrix.h"
+
+/**< STD headers >**/
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Lower bounds for the cost of completing a partial path
+ */
+enum BOUND_TYPE{
+    TWO_EDGES,     /**< Half of the two cheapest edges incident to every vertex left >**/
+    ONE_TREE,      /**< MST of the vertices left plus the cheapest edges joining it to the path ends >**/
+    REDUCED_MATRIX, /**< Row and column reduction of the matrix of the edges left >**/
+    ASSIGNMENT     /**< Optimal assignment (Hungarian) of the edges left, the strongest for directed graphs >**/
+};
+
+/**
+ * @struct SearchProgress
+ * @brief State of a running search, the optimum is between bound and incumbent
+ */
+struct SearchProgress {
+    double incumbent; /**< Best tour cost found (infinity if none yet) >**/
+    double bound; /**< Best known lower bound of the optimum >**/
+    unsigned long long nodes; /**< Nodes expanded >**/
+    size_t open; /**< Nodes waiting to be expanded >**/
+    double elapsed; /**< Seconds since the search started >**/
+    double rate; /**< Nodes per second >**/
+};
+
+typedef function<void(const SearchProgress&)> ProgressCallback;
+
+/**
+ * @class BranchBound
+ * @brief Depth first branch and bound over a DistanceMatrix (index 0 is the start).
+ *
+ * The incumbent is seeded with a nearest neighbour tour (improved by 2-opt when the matrix is symmetric), children are
+ * expanded nearest first and a node is pruned when its cost plus the lower bound of the rest can't beat the incumbent.
+ * Every bound works on asymmetric matrices too. The assignment bound is solved from scratch at most once per subtree, a
+ * child reuses the assignment and the potentials of its parent and only needs up to two augmenting paths. Symmetric
+ * tours are only searched in one direction and paths that a 2-opt or Or-opt move makes cheaper are skipped, neither
+ * removes every optimal tour.
+ *
+ * The parallel search splits the tree into subtrees on per-thread deques: a thread works depth first on its own deque
+ * and steals the oldest (largest) subtree of another thread when it runs out of work. Nodes are only split while some
+ * thread is idle, so the split depth follows the demand for work.
+ *
+ * The best first search always expands the open node with the lowest bound, which raises the global lower bound as soon
+ * as possible. Nodes are 32 byte records and the search falls back to depth first from the open nodes (lowest bound
+ * first) when the records would pass the memory cap.
+ *
+ * Every search can stop at a deadline. The subtrees not searched yet (the frontier) can then be saved to a checkpoint
+ * with the incumbent, and any search mode can resume from a loaded checkpoint instead of from the start.
+ */
+class BranchBound {
+public:
+    /**
+     * @constructor BranchBound
+     * @Complexity - O(V^2 log V) to sort the neighbours of every vertex
+     * @param matrix - distances, must outlive the search
+     * @param bound - lower bound used to prune
+     */
+    BranchBound(const DistanceMatrix& matrix, BOUND_TYPE bound);
+
+    /**
+     * @brief Runs the search
+     * @Complexity - O(V!) in the worst case, O(V^2) per node for the bound
+     * @param order - best order found (indices starting at 0), empty if there is no tour
+     * @return cost of the best tour, infinity if there is no tour
+     */
+    double solve(vector<int>& order);
+
+    /**
+     * @brief Runs the work-stealing parallel search
+     *
+     * Nodes whose bound equals the incumbent are not pruned and ties are broken by the smallest order, so the tour
+     * returned does not depend on the threads or their timing.
+     *
+     * @Complexity - O(V!) in the worst case, O(V^2) per node for the bound
+     * @param order - best order found (indices starting at 0), empty if there is no tour
+     * @param threads - number of threads
+     * @return cost of the best tour, infinity if there is no tour
+     */
+    double parallelSolve(vector<int>& order, int threads);
+
+    /**
+     * @brief Runs the best first search (lowest bound first)
+     * @note Only instances up to 64 vertices fit the node bitmask, bigger ones are searched depth first
+     * @Complexity - O(V!) in the worst case, O(V^2) per child for the bound, O(memory_cap) memory
+     * @param order - best order found (indices starting at 0), empty if there is no tour
+     * @param memory_cap - bytes allowed for the node records
+     * @return cost of the best tour, infinity if there is no tour
+     */
+    double bestFirstSolve(vector<int>& order, size_t memory_cap);
+
+    /**
+     * @brief Reports the search state periodically
+     * @param callback - called from a searching thread, nullptr disables it
+     * @param period - seconds between reports
+     */
+    void setProgress(ProgressCallback callback, double period = PROGRESS_PERIOD);
+
+    /**
+     * @brief Stops the next searches after some wall-clock time
+     * @param seconds - time limit, 0 for none
+     */
+    void setTimeLimit(double seconds);
+
+    /**
+     * @brief Checks if the last search ended (optimum proven) instead of stopping at the deadline
+     * @return true if complete
+     */
+    [[nodiscard]] bool isComplete() const;
+
+    /**
+     * @brief Saves the frontier of the last search, the incumbent and the counters to a binary file
+     * @note Written to path + ".tmp" first and then renamed, so a crash never leaves a half written checkpoint
+     * @param path - checkpoint file
+     */
+    void saveCheckpoint(const string& path) const;
+
+    /**
+     * @brief Loads a checkpoint, the next search resumes from its frontier and incumbent
+     * @note Throws FILE_ERROR if the file can't be read or was saved for another matrix
+     * @param path - checkpoint file
+     */
+    void loadCheckpoint(const string& path);
+
+    /**
+     * @brief Best known lower bound of the optimum (equal to the cost found once a search ends)
+     * @note Can be read while a search runs
+     * @return bound
+     */
+    [[nodiscard]] double getLowerBound() const;
+
+    /**
+     * @brief Nodes expanded by the last search
+     * @return nodes
+     */
+    [[nodiscard]] unsigned long long getNodes() const;
+
+    /**
+     * @brief Nodes expanded by each thread in the last search
+     * @return nodes per thread
+     */
+    [[nodiscard]] vector<unsigned long long> getThreadNodes() const;
+
+private:
+    /**
+     * @struct Subtree
+     * @brief Path whose children are still to be searched
+     */
+    struct Subtree {
+        vector<int> path;
+        double cost;
+        double bound = -DistanceMatrix::INF; /**< Lower bound of its tours, -infinity until computed >**/
+    };
+
+    /**
+     * @struct Checkpoint
+     * @brief State loaded from a checkpoint file
+     */
+    struct Checkpoint {
+        unsigned long long nodes = 0; /**< Nodes expanded before >**/
+        double lower_bound = 0; /**< Best known lower bound >**/
+        double best = DistanceMatrix::INF; /**< Incumbent cost >**/
+        vector<int> best_path; /**< Incumbent order >**/
+        vector<Subtree> frontier; /**< Subtrees left >**/
+    };
+
+    /**
+     * @struct Node
+     * @brief Open node of the best first search, the path is rebuilt from the parents
+     */
+    struct Node {
+        uint64_t mask; /**< Vertices in the path >**/
+        double cost; /**< Cost of the path >**/
+        double bound; /**< Cost plus lower bound of the rest >**/
+        uint32_t parent; /**< Index of the parent record, NO_PARENT for the root >**/
+        uint8_t last; /**< Last vertex of the path >**/
+        uint8_t depth; /**< Vertices in the path >**/
+    };
+
+    /**
+     * @struct Assignment
+     * @brief Optimal assignment of one node with its dual potentials, a perfect matching of the rows (current and the
+     * vertices left) and the columns (the vertices left and the start)
+     */
+    struct Assignment {
+        int current = -1; /**< Last vertex of the path it was solved for, -1 if none >**/
+        vector<int> column; /**< Column of each row, -1 for the vertices that are not a row >**/
+        vector<int> row; /**< Row of each column, -1 for the vertices that are not a column >**/
+        vector<double> u; /**< Row potentials >**/
+        vector<double> v; /**< Column potentials >**/
+    };
+
+    /**
+     * @struct Worker
+     * @brief State of one searching thread
+     */
+    struct Worker {
+        vector<char> visited; /**< Vertices in the path >**/
+        vector<int> path; /**< Current path >**/
+        vector<int> left; /**< Scratch, unvisited vertices >**/
+        vector<double> key; /**< Scratch, Prim keys >**/
+        vector<double> reduce; /**< Scratch, row minimums >**/
+        vector<Assignment> assignments; /**< Assignment of the node at each depth, warm start of its children >**/
+        vector<int> way; /**< Scratch, previous column on the augmenting path >**/
+        vector<char> used; /**< Scratch, columns reached by the augmenting path >**/
+        int id = 0; /**< Worker index >**/
+        atomic<unsigned long long> nodes{0}; /**< Nodes expanded, only written by the owner >**/
+        deque<Subtree> subtrees; /**< Work of the thread, the owner uses the back, thieves the front >**/
+        mutex lock; /**< Protects subtrees >**/
+    };
+
+    /**
+     * @brief Creates the workers with their scratch buffers and resets the incumbent (or restores a loaded checkpoint)
+     * @param threads - number of workers
+     */
+    void prepare(int threads);
+
+    /**
+     * @brief Subtrees a search starts from: the loaded frontier when resuming, else the whole tree
+     * @return subtrees
+     */
+    vector<Subtree> startingSubtrees();
+
+    /**
+     * @brief Depth first search of some subtrees one after the other
+     * @param subtrees - subtrees to search
+     */
+    void searchSubtrees(const vector<Subtree>& subtrees);
+
+    /**
+     * @brief Common end of the searches, the bound of the frontier becomes the lower bound if the search stopped
+     * @param order - best order found
+     * @return cost of the best tour
+     */
+    double finish(vector<int>& order);
+
+    /**
+     * @brief Loads a subtree path in the worker
+     * @param worker - state of the thread
+     * @param subtree - subtree
+     */
+    static void enter(Worker& worker, const Subtree& subtree);
+
+    /**
+     * @brief Clears a subtree path from the worker
+     * @param worker - state of the thread
+     * @param subtree - subtree
+     */
+    static void leave(Worker& worker, const Subtree& subtree);
+
+    /**
+     * @brief Counts a node of a worker, checks the deadline and reports every POLL_NODES nodes
+     * @param worker - state of the thread
+     * @param open - nodes waiting to be expanded
+     */
+    void count(Worker& worker, size_t open);
+
+    /**
+     * @brief Adds a subtree to the frontier (search stopped)
+     * @param path - path of the subtree
+     * @param cost - cost of the path
+     * @param bound - lower bound of its tours if known
+     */
+    void keep(const vector<int>& path, double cost, double bound = -DistanceMatrix::INF);
+
+    /**
+     * @brief Depth first search from the last vertex of the path
+     * @param worker - state of the thread
+     * @param current - last vertex of the path
+     * @param cost - cost of the path
+     */
+    void search(Worker& worker, int current, double cost);
+
+    /**
+     * @brief Pushes the children of a node that are not pruned as subtrees of the worker (nearest on the back)
+     * @param worker - state of the thread
+     * @param current - last vertex of the path
+     * @param cost - cost of the path
+     */
+    void split(Worker& worker, int current, double cost);
+
+    /**
+     * @brief Thread body of the parallel search, runs until every subtree is done
+     * @param id - worker index
+     */
+    void work(int id);
+
+    /**
+     * @brief Takes a subtree from the back of the own deque or the front of another one
+     * @param id - worker index
+     * @param subtree - taken subtree
+     * @return true if a subtree was taken
+     */
+    bool take(int id, Subtree& subtree);
+
+    /**
+     * @brief Rebuilds the path of a best first record
+     * @param nodes - records
+     * @param index - record
+     * @param path - path from the start
+     */
+    static void pathOf(const vector<Node>& nodes, uint32_t index, vector<int>& path);
+
+    /**
+     * @brief Calls the progress callback when a period passed since the last report
+     * @param open - nodes waiting to be expanded
+     */
+    void report(size_t open);
+
+    /**
+     * @brief Checks if appending a vertex to the path of a worker breaks the direction of symmetric tours (vertex 1
+     * must come before vertex 2) or gives a path that a 2-opt / Or-opt move improves
+     * @param worker - state of the thread
+     * @param next - vertex to append
+     * @return true if the child can be skipped
+     */
+    [[nodiscard]] bool rejected(const Worker& worker, int next) const;
+
+    /**
+     * @brief Checks if a path with a cost (or lower bound) can be dropped
+     * @param value - cost or lower bound
+     * @return true if it can't improve the incumbent (or tie with it, in the parallel search)
+     */
+    [[nodiscard]] bool pruned(double value) const;
+
+    /**
+     * @brief Offers a complete tour as incumbent
+     * @param path - order
+     * @param cost - tour cost
+     */
+    void offer(const vector<int>& path, double cost);
+
+    /**
+     * @brief Nearest neighbour tour followed by 2-opt (symmetric only), becomes the first incumbent
+     * @Complexity - O(V^2) per 2-opt pass
+     */
+    void seedIncumbent();
+
+    /**
+     * @brief Lower bound of the cost of going from current through every unvisited vertex and back to the start
+     * @Complexity - O(V^2)
+     * @param worker - state of the thread
+     * @param current - last vertex of the path
+     * @return bound, infinity if the path can't be completed
+     */
+    double lowerBound(Worker& worker, int current);
+
+    /**
+     * @brief Every unvisited vertex is entered and left once, so half of its two cheapest edges is a lower bound of what
+     * it adds to the rest of the path (asymmetric: the larger of the sums of cheapest out and cheapest in edges)
+     * @param worker - state of the thread
+     * @param current - last vertex of the path
+     * @return bound
+     */
+    double twoEdgesBound(Worker& worker, int current);
+
+    /**
+     * @brief The rest of the path is a spanning path of the unvisited vertices plus one edge at each end
+     * @param worker - state of the thread
+     * @param current - last vertex of the path
+     * @return bound
+     */
+    double oneTreeBound(Worker& worker, int current);
+
+    /**
+     * @brief Reduction of the matrix with rows current + unvisited and columns unvisited + start (assignment bound)
+     * @param worker - state of the thread
+     * @param current - last vertex of the path
+     * @return bound
+     */
+    double reducedMatrixBound(Worker& worker, int current);
+
+    /**
+     * @brief Optimal assignment of the rows current + unvisited to the columns unvisited + start (current -> start
+     * forbidden), warm started from the assignment of the parent when the worker holds it
+     * @Complexity - O(V^2) from the parent, O(V^3) from scratch
+     * @param worker - state of the thread
+     * @param current - last vertex of the path
+     * @return bound
+     */
+    double assignmentBound(Worker& worker, int current);
+
+    /**
+     * @brief Checks if an assignment was solved for the parent of a node (same vertices plus the parent last vertex)
+     * @param worker - state of the thread, visited is the node path
+     * @param parent - assignment
+     * @param current - last vertex of the node path
+     * @return true if it can warm start the node
+     */
+    bool isParentAssignment(const Worker& worker, const Assignment& parent, int current) const;
+
+    /**
+     * @brief Shortest augmenting path (Hungarian step) from a free row, keeps the potentials feasible
+     * @Complexity - O(V^2)
+     * @param worker - state of the thread, left holds the columns
+     * @param state - assignment
+     * @param free_row - row to assign
+     * @return false if the row can't be assigned
+     */
+    bool augment(Worker& worker, Assignment& state, int free_row);
+
+    static constexpr double PROGRESS_PERIOD = 1; /**< Default seconds between reports >**/
+    static constexpr unsigned long long POLL_NODES = 1 << 10; /**< Nodes between deadline checks (power of 2) >**/
+    static constexpr char CHECKPOINT_MAGIC[4] = {'T', 'S', 'P', 'C'}; /**< Checkpoint file signature >**/
+    static constexpr uint32_t CHECKPOINT_VERSION = 1; /**< Checkpoint format version >**/
+    static constexpr uint32_t NO_PARENT = UINT32_MAX; /**< Parent of the root record >**/
+    static constexpr int SPLIT_MIN = 6; /**< Subtrees with fewer vertices left are never split >**/
+    static constexpr double TIE_TOLERANCE = 1e-12; /**< Relative rounding allowed on bounds equal to the incumbent >**/
+
+    const DistanceMatrix& matrix; /**< Distances >**/
+    BOUND_TYPE bound; /**< Bound used to prune >**/
+    int n; /**< Number of vertices >**/
+    bool symmetric; /**< d(i, j) == d(j, i) for every pair >**/
+    vector<vector<int>> nearest; /**< Other vertices sorted by distance from each vertex >**/
+
+    vector<unique_ptr<Worker>> workers; /**< One per thread >**/
+    bool parallel = false; /**< Parallel (tie keeping) search >**/
+    atomic<long long> pending{0}; /**< Subtrees queued or being searched >**/
+    atomic<int> idle{0}; /**< Threads looking for work >**/
+
+    mutex incumbent_lock; /**< Protects best_path and the writes to best >**/
+    vector<int> best_path; /**< Incumbent order >**/
+    atomic<double> best{DistanceMatrix::INF}; /**< Incumbent cost >**/
+    atomic<double> lower_bound{0}; /**< Best known lower bound >**/
+
+    ProgressCallback progress; /**< Progress callback, may be empty >**/
+    double progress_period = PROGRESS_PERIOD; /**< Seconds between reports >**/
+    double next_report = PROGRESS_PERIOD; /**< Elapsed seconds of the next report >**/
+    mutex report_lock; /**< One report at a time >**/
+
+    double time_limit = 0; /**< Seconds allowed per search, 0 for none >**/
+    chrono::steady_clock::time_point started; /**< Start of the search >**/
+    atomic<bool> stopped{false}; /**< Deadline reached >**/
+    unsigned long long base_nodes = 0; /**< Nodes expanded before a resumed search >**/
+
+    mutex frontier_lock; /**< Protects frontier >**/
+    vector<Subtree> frontier; /**< Subtrees left when the search stopped >**/
+    Checkpoint resume; /**< Loaded checkpoint >**/
+    bool resuming = false; /**< Next search starts from resume >**/
+};
+
+#endif //TSP_ANALYSIS_BRANCHBOUND_H
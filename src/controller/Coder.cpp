@@ -1,10 +1,24 @@
 #include "Coder.h"
+#include "ThreadPool.h"
+#include "TinySolver.h"
+#include "KdTree.h"
 #include <limits>
 #include <stack>
 #include <random>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
+#include <filesystem>
 #include <queue>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <atomic>
+#include <numeric>
+#include <unistd.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 void Coder::setNewTable(HashTable* table){
     this->vertices_table = table;
@@ -16,25 +30,16 @@ void Coder::setNewGraph(Graph* _graph){
 /**
  * @note Distance between two vertices
  */
-double Coder::haversineDistance(Vertex* origin, Vertex* destination) {
+bool Coder::canMeasure(Vertex* origin, Vertex* destination) const {
+    return graph->getMetric()->canMeasure(origin, destination);
+}
+
+double Coder::measureDistance(Vertex* origin, Vertex* destination) const {
     try {
         if (origin == nullptr || destination == nullptr) {
             throw CustomError("NullPtr error - origin/destination are null ptr", ERROR);
         }
-        Coordinate *originCoord = origin->getCoordinates();
-        Coordinate *destinationCoord = destination->getCoordinates();
-
-        if (originCoord == nullptr || destinationCoord == nullptr) {
-            throw CustomError("NullPtr error - coordinates are null ptr", ERROR);
-        }
-
-        double delta_lat = (destinationCoord->getLatitude() - originCoord->getLatitude()) * M_PI / 180;
-        double delta_lon = (destinationCoord->getLongitude() - originCoord->getLongitude()) * M_PI / 180;
-        double a = pow(sin(delta_lat / 2), 2) +
-                   pow(sin(delta_lon / 2), 2) * cos(originCoord->getLatitude()) * cos(destinationCoord->getLatitude());
-        double c = 2 * asin(sqrt(a));
-        double d = 6371.0 * c * 1000;
-        return d;
+        return graph->getMetric()->distance(origin, destination);
     }
     catch (const CustomError& e){
         cerr << e.what() << endl;
@@ -100,250 +105,620 @@ bool Coder::isGraphComplete() {
 /**
   @note Backtracking implementation
  */
-void Coder::backtrackingHelper(Vertex* start, double& min_distance, Vertex* current_vertex, double current_distance, Tour& path, Tour& min_path, bool is_complete) {
-    if (start == nullptr || current_vertex == nullptr){
-        throw CustomError("NullPtr error: vertex current/start is a nullptr", ERROR);
-    }
-    if (path.size() == graph->getNumberOfVertexes() - 1){
-        double distance_to_origin;
-        bool findCycle = false;
-        for (Edge* e : current_vertex->getAdj()){
-            if (e == nullptr){
-                throw CustomError("NullPtr error: edge e is a nullptr", ERROR);
-            }
-            if (e->getDestination()->getId() == start->getId()){
-                distance_to_origin = e->getDistance();
-                path.push_back(e);
-                findCycle = true;
-                break;
+
+/**
+ * @brief Iterative enumeration of every tour starting at index 0.
+ *
+ * Level k of the stack holds the k-th vertex of the path, the cost up to it and the next vertex to try there, so going
+ * down or back up a level only touches these arrays and the visited mask (no allocation per node). Symmetric tours are
+ * enumerated in one direction and paths improved by a 2-opt / Or-opt move are skipped (see DistanceMatrix::isDominated).
+ * The clock is only read every POLL_NODES nodes, for the time limit and the progress reports.
+ *
+ * @return tour cost (infinity if there is no tour) and the order in `order`, stopped is set if the time ran out
+ */
+static double enumerateTours(const DistanceMatrix& matrix, vector<int>& order, unsigned long long& nodes,
+                             double time_limit, const ProgressCallback& progress, bool& stopped) {
+    constexpr unsigned long long POLL_NODES = 1 << 12;
+    auto started = chrono::steady_clock::now();
+    double next_report = 1;
+    int n = matrix.size();
+    vector<int> path(n, 0);
+    vector<int> next(n + 1, 1);
+    vector<double> cost(n, 0);
+    uint64_t visited = 1;
+    bool symmetric = matrix.isSymmetric();
+    double best = DistanceMatrix::INF;
+    order.assign(n, 0);
+    nodes = 0;
+    stopped = false;
+
+    int k = 1;
+    while (k >= 1) {
+        if (k == n) {
+            double total = cost[n - 1] + matrix.get(path[n - 1], 0);
+            if (total < best) {
+                best = total;
+                copy(path.begin(), path.end(), order.begin());
             }
+            k--;
+            visited &= ~(uint64_t(1) << path[k]);
+            continue;
         }
 
-        if (!findCycle){
-            if (!is_complete) {
-                if (current_vertex->getCoordinates() != nullptr && start->getCoordinates() != nullptr) {
-                    distance_to_origin = haversineDistance(current_vertex, start);
-                    Edge* e = graph->addEdge(current_vertex, start, distance_to_origin);
-                    path.push_back(e);
-                }
-                else{
-                    return;
-                }
-            }
-            else{
-                return;
+        const double* row = matrix.row(path[k - 1]);
+        int v = next[k];
+        // Symmetric tours only in one direction (vertex 1 before vertex 2), dominated paths are skipped
+        while (v < n && (((visited >> v) & 1) || row[v] == DistanceMatrix::INF ||
+                         (symmetric && v == 2 && !(visited & 2)) || matrix.isDominated(path.data(), k, v, symmetric))) {
+            v++;
+        }
+        if (v == n) {
+            // Level exhausted, back to the previous one
+            k--;
+            if (k >= 1) {
+                visited &= ~(uint64_t(1) << path[k]);
             }
+            continue;
         }
 
-        double total_distance = current_distance + distance_to_origin;
-        if (total_distance < min_distance){
-            min_distance = total_distance;
-            min_path.assign(path.begin(), path.end());
+        next[k] = v + 1;
+        path[k] = v;
+        cost[k] = cost[k - 1] + row[v];
+        visited |= uint64_t(1) << v;
+        nodes++;
+        k++;
+        next[k] = 1;
+
+        if ((nodes & (POLL_NODES - 1)) == 0 && (time_limit > 0 || progress)) {
+            double elapsed = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+            if (progress && elapsed >= next_report) {
+                next_report = elapsed + 1;
+                progress({best, 0, nodes, 0, elapsed, static_cast<double>(nodes) / elapsed});
+            }
+            if (time_limit > 0 && elapsed >= time_limit) {
+                stopped = true;
+                break;
+            }
         }
-        path.pop_back();
-        return;
     }
-    vector<Vertex*> connected;
-    for (Edge* e : current_vertex->getAdj()){
-        connected.push_back(e->getDestination());
-        Vertex* destination = e->getDestination();
-        if (destination == nullptr){
-            throw CustomError("NullPtr error: vertex v is a nullptr", ERROR);
-        }
+    if (best == DistanceMatrix::INF) {
+        order.clear();
+    }
+    return best;
+}
 
-        if (!destination->isVisited()){
-            destination->setVisited(true);
-            current_distance+= e->getDistance();
-            path.push_back(e);
+Result Coder::backtracking(int start_vertex) {
+    // Initialize Timer
+    timespec start_real{};
+    timespec start_cpu{};
+    double elapsed_real, elapsed_cpu;
+    startTimer(start_real, start_cpu);
 
-            backtrackingHelper(start,min_distance,destination,current_distance,path,min_path,is_complete);
+    // Start vertex
+    Vertex *start = vertices_table->search(start_vertex);
+    if (start == nullptr) {
+        throw CustomError("NullPtr: vertex start is a null ptr", ERROR);
+    }
+    DistanceMatrix matrix(graph, start);
+    int n = matrix.size();
+    if (n < 2) {
+        return {};
+    }
+    if (n > 64) {
+        CustomError("Backtracking supports up to 64 vertices, the graph has " + to_string(n), INFO).what();
+        return {};
+    }
 
-            destination->setVisited(false);
-            current_distance-= e->getDistance();
-            path.pop_back();
-        }
+    vector<int> order;
+    unsigned long long nodes;
+    bool stopped;
+    double distance = enumerateTours(matrix, order, nodes, time_limit, progress, stopped);
+    if (distance == DistanceMatrix::INF) {
+        return {};
     }
-    if (!is_complete) {
-        for (Vertex *v: graph->getVertexSet()) {
-            if (!v->isVisited() && find(connected.begin(), connected.end(), v) == connected.end()) {
-                if (current_vertex->getCoordinates() == nullptr || v->getCoordinates() == nullptr) {
-                    continue;
-                }
-                double haversine_dist = haversineDistance(current_vertex, v);
-                Edge *new_edge = graph->addEdge(current_vertex, v, haversine_dist);
-                current_distance += haversine_dist;
-                path.push_back(new_edge);
-                v->setVisited(true);
 
-                backtrackingHelper(start, min_distance, v, current_distance, path, min_path, is_complete);
+    Tour tour = orderToTour(matrix, order);
 
-                v->setVisited(false);
-                current_distance -= haversine_dist;
-                path.pop_back();
-            }
-        }
+    // Finish Timer
+    Time t = stopTimer(start_real, start_cpu, elapsed_real, elapsed_cpu);
+    if (tour.empty()) {
+        return {};
     }
+    Result result = {tour, distance, t, nodes};
+    result.stopped = stopped;
+    result.lower_bound = stopped ? 0 : distance;
+    return result;
+}
+
+/**
+ * @note Branch-bound implementation
+ */
+Result Coder::branchBound(int start_vertex, BOUND_TYPE bound) {
+    return branchBoundSolve(start_vertex, bound, 0);
+}
+
+Result Coder::parallelBranchBound(int start_vertex, BOUND_TYPE bound, int threads) {
+    return branchBoundSolve(start_vertex, bound, ThreadPool::resolveThreads(threads));
 }
 
+Result Coder::bestFirstBranchBound(int start_vertex, BOUND_TYPE bound) {
+    return branchBoundSolve(start_vertex, bound, 0, true);
+}
 
+void Coder::setProgress(ProgressCallback callback) {
+    progress = std::move(callback);
+}
 
-Result Coder::backtracking(int start_vertex) {
+void Coder::setTimeLimit(double seconds) {
+    time_limit = max(seconds, 0.0);
+}
+
+double Coder::getTimeLimit() const {
+    return time_limit;
+}
+
+void Coder::setCheckpoint(const string& path) {
+    checkpoint_path = path;
+}
+
+const string& Coder::getCheckpoint() const {
+    return checkpoint_path;
+}
+
+Result Coder::branchBoundSolve(int start_vertex, BOUND_TYPE bound, int threads, bool best_first) {
     // Initialize Timer
     timespec start_real{};
     timespec start_cpu{};
     double elapsed_real, elapsed_cpu;
     startTimer(start_real, start_cpu);
-    bool is_complete = isGraphComplete();
 
-    // Set all vertex to visited false
-    for (Vertex *v: graph->getVertexSet()) {
-        if (v == nullptr) {
-            throw CustomError("NullPtr: vertex v is a null ptr", ERROR);
-        }
-        v->setVisited(false);
-    }
-
-    // Initialize distance
-    double min_distance = numeric_limits<double>::max();
-
-    // Start vertex (visited)
+    // Start vertex
     Vertex *start = vertices_table->search(start_vertex);
     if (start == nullptr) {
         throw CustomError("NullPtr: vertex start is a null ptr", ERROR);
     }
-    start->setVisited(true);
-
-    // Path
-    Tour min_path;
-    Tour path;
+    DistanceMatrix matrix(graph, start);
+    if (matrix.size() < 2) {
+        return {};
+    }
 
-    // Backtracking calculation
-    backtrackingHelper(start, min_distance, start, 0, path, min_path,is_complete);
+    BranchBound search(matrix, bound);
+    vector<int> order;
+    search.setProgress(progress);
+    search.setTimeLimit(time_limit);
+    if (!checkpoint_path.empty() && filesystem::exists(checkpoint_path)) {
+        try {
+            search.loadCheckpoint(checkpoint_path);
+            CustomError("Resuming from the checkpoint " + checkpoint_path, INFO).what();
+        }
+        catch (CustomError& e) {
+            // A checkpoint of another graph (or a broken one) is ignored, the search starts over
+            e.what();
+        }
+    }
+    double distance;
+    if (best_first) {
+        distance = search.bestFirstSolve(order, memory_limit);
+    }
+    else {
+        distance = (threads == 0) ? search.solve(order) : search.parallelSolve(order, threads);
+    }
+    if (!checkpoint_path.empty()) {
+        if (search.isComplete()) {
+            error_code error;
+            filesystem::remove(checkpoint_path, error);
+        }
+        else {
+            try {
+                search.saveCheckpoint(checkpoint_path);
+                CustomError("Search stopped, checkpoint saved to " + checkpoint_path, INFO).what();
+            }
+            catch (CustomError& e) {
+                e.what();
+            }
+        }
+    }
+    if (distance == DistanceMatrix::INF) {
+        return {};
+    }
 
+    Tour tour = orderToTour(matrix, order);
 
     // Finish Timer
     Time t = stopTimer(start_real, start_cpu, elapsed_real, elapsed_cpu);
-    return {min_path, min_distance, t};
+    if (tour.empty()) {
+        return {};
+    }
+    Result result = {tour, distance, t, search.getNodes()};
+    result.stopped = !search.isComplete();
+    result.lower_bound = search.getLowerBound();
+    if (threads != 0) {
+        result.thread_nodes = search.getThreadNodes();
+    }
+    return result;
 }
 
+
 /**
- * @note Branch-bound implementation
+ * @note Held-Karp implementation
  */
-void Coder::branchBoundHelper(Vertex* start, double& min_distance, Vertex* current_vertex, double current_distance, Tour& path, Tour& min_path) {
-    if (start == nullptr || current_vertex == nullptr){
-        throw CustomError("NullPtr error: vertex current/start is a nullptr", ERROR);
-    }
-    if (path.size() == graph->getNumberOfVertexes() - 1){
-        double distance_to_origin;
-        bool findCycle = false;
-        for (Edge* e : current_vertex->getAdj()){
-            if (e == nullptr){
-                throw CustomError("NullPtr error: edge e is a nullptr", ERROR);
-            }
-            if (e->getDestination()->getId() == start->getId()){
-                distance_to_origin = e->getDistance();
-                path.push_back(e);
-                findCycle = true;
-                break;
+size_t Coder::getDefaultMemoryLimit() {
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long page_size = sysconf(_SC_PAGE_SIZE);
+    if (pages <= 0 || page_size <= 0) {
+        return size_t(1) << 30;
+    }
+    return static_cast<size_t>(pages) / 4 * 3 * static_cast<size_t>(page_size);
+}
+
+size_t Coder::getMemoryLimit() const {
+    return memory_limit;
+}
+
+void Coder::setMemoryLimit(size_t bytes) {
+    memory_limit = bytes;
+}
+
+size_t Coder::heldKarpMemory(int n, size_t cost_size) {
+    if (n <= 1) {
+        return 0;
+    }
+    auto m = static_cast<size_t>(n - 1);
+    if (m >= 8 * sizeof(size_t) - 8) {
+        return SIZE_MAX;
+    }
+    size_t subsets = size_t(1) << m;
+    size_t entry = cost_size + sizeof(uint8_t);
+    if (subsets > SIZE_MAX / m / entry) {
+        return SIZE_MAX;
+    }
+    return subsets * m * entry;
+}
+
+size_t Coder::graphHeldKarpMemory() const {
+    int n = graph->getNumberOfVertexes();
+    // heldKarp refuses these sizes before building its matrix
+    if (n < 2 || n - 1 > UINT8_MAX) {
+        return heldKarpMemory(n);
+    }
+    DistanceMatrix matrix(graph, graph->getVertexSet().front());
+    return heldKarpMemory(n, heldKarpCostSize(matrix));
+}
+
+size_t Coder::heldKarpCostSize(const DistanceMatrix& matrix) const {
+    // Integers are exact if a tour can't overflow them, else doubles (floats if doubles don't fit)
+    int n = matrix.size();
+    if (matrix.isIntegral() && matrix.getMaxDistance() * n < static_cast<double>(INT32_MAX)) {
+        return sizeof(int32_t);
+    }
+    return (heldKarpMemory(n, sizeof(double)) > memory_limit) ? sizeof(float) : sizeof(double);
+}
+
+Tour Coder::orderToTour(const DistanceMatrix& matrix, const vector<int>& order) {
+    vector<Vertex*> vertices;
+    vertices.reserve(order.size());
+    for (int i : order) {
+        vertices.push_back(matrix.getVertex(i));
+    }
+    return verticesToTour(vertices);
+}
+
+Tour Coder::verticesToTour(const vector<Vertex*>& order) {
+    // Every vertex appears once, so an edge only writes the out edges of its origin and the in edges of its
+    // destination, which no other edge of the tour touches: large tours are built in parallel
+    size_t n = order.size();
+    Tour tour(n, nullptr);
+    atomic<bool> failed{false};
+    auto build = [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end && !failed.load(memory_order_relaxed); i++) {
+            // Orders rarely follow memory, fetch the vertices and their coordinates a few steps ahead
+            if (i + 16 < n) {
+                __builtin_prefetch(order[i + 16]);
+            }
+            if (i + 8 < n) {
+                __builtin_prefetch(order[i + 8]->getCoordinates());
             }
+            Vertex* origin = order[i];
+            Vertex* destination = order[(i + 1) % n];
+            Edge* e = graph->getEdgeFromGraph(origin, destination);
+            if (e == nullptr) {
+                if (!canMeasure(origin, destination)) {
+                    failed.store(true, memory_order_relaxed);
+                    return;
+                }
+                e = graph->addEdge(origin, destination, measureDistance(origin, destination));
+            }
+            tour[i] = e;
         }
+    };
+    if (n >= PARALLEL_TOUR_VERTICES) {
+        ThreadPool pool(0);
+        pool.parallelFor(0, n, 4096, build);
+    }
+    else {
+        build(0, n, 0);
+    }
+    if (failed.load()) {
+        return {};
+    }
+    return tour;
+}
 
-        if (!findCycle){
-            return;
+/**
+ * @brief Held-Karp table over the subsets of the vertices 1..n-1 (vertex 0 is the start).
+ *
+ * Entry (mask, j) is the cheapest path 0 -> ... -> j+1 visiting exactly the vertices of mask, with j in mask. Subsets
+ * are solved layer by layer (by number of vertices), a layer only reads the previous one, so with a pool every layer
+ * is split in blocks of consecutive subsets (in increasing order) solved in parallel. Each entry is computed exactly
+ * as in the sequential order, so the optimum is the same. The table is not initialized up front: an entry is first
+ * written by the thread that solves it, which keeps its pages local to that thread.
+ *
+ * @return tour cost (infinity if there is no tour) and the order in `order`
+ */
+template<typename Cost>
+static double heldKarpTable(const DistanceMatrix& matrix, vector<int>& order, ThreadPool* pool) {
+    const int n = matrix.size();
+    const int m = n - 1;
+    const size_t subsets = size_t(1) << m;
+    const Cost INF = numeric_limits<Cost>::max();
+
+    // Compact copy of the distances in the table type
+    vector<Cost> w(static_cast<size_t>(n) * n, INF);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            if (matrix.get(i, j) != DistanceMatrix::INF) {
+                w[static_cast<size_t>(i) * n + j] = static_cast<Cost>(matrix.get(i, j));
+            }
         }
+    }
 
-        double total_distance = current_distance + distance_to_origin;
-        if (total_distance < min_distance){
-            min_distance = total_distance;
-            min_path.assign(path.begin(), path.end());
-        }
-        path.pop_back();
-        return;
+    // Only entries (mask, j) with j in mask are written and read
+    unique_ptr<Cost[]> cost(new Cost[subsets * m]);
+    unique_ptr<uint8_t[]> parent(new uint8_t[subsets * m]);
+    for (int j = 0; j < m; j++) {
+        cost[(size_t(1) << j) * m + j] = w[j + 1];
     }
 
-    for (Edge* e : current_vertex->getAdj()){
-        if (e == nullptr){
-            throw CustomError("NullPtr error: edge e is a nullptr", ERROR);
+    auto solveSubset = [&](size_t mask) {
+        Cost* row = cost.get() + mask * m;
+        uint8_t* parents = parent.get() + mask * m;
+        for (size_t bits = mask; bits != 0; bits &= bits - 1) {
+            int j = __builtin_ctzll(bits);
+            size_t previous = mask ^ (size_t(1) << j);
+            const Cost* previous_row = cost.get() + previous * m;
+            const Cost* to_j = w.data() + j + 1;
+            Cost best = INF;
+            int best_k = 0;
+            for (size_t others = previous; others != 0; others &= others - 1) {
+                int k = __builtin_ctzll(others);
+                Cost c = previous_row[k];
+                Cost d = to_j[static_cast<size_t>(k + 1) * n];
+                if (c == INF || d == INF) {
+                    continue;
+                }
+                if (c + d < best) {
+                    best = c + d;
+                    best_k = k;
+                }
+            }
+            row[j] = best;
+            parents[j] = static_cast<uint8_t>(best_k);
         }
-        Vertex* destination = e->getDestination();
-        if (destination == nullptr){
-            throw CustomError("NullPtr error: vertex v is a nullptr", ERROR);
+    };
+
+    // Binomial coefficients to find the first subset of a block (combinatorial number system)
+    vector<vector<size_t>> binomial(m + 1, vector<size_t>(m + 1, 0));
+    for (int a = 0; a <= m; a++) {
+        binomial[a][0] = 1;
+        for (int b = 1; b <= a; b++) {
+            binomial[a][b] = binomial[a - 1][b - 1] + (b <= a - 1 ? binomial[a - 1][b] : 0);
         }
+    }
+    auto unrank = [&](size_t rank, int k) {
+        size_t mask = 0;
+        for (int i = k; i >= 1; i--) {
+            int c = i - 1;
+            while (c + 1 < m && binomial[c + 1][i] <= rank) {
+                c++;
+            }
+            mask |= size_t(1) << c;
+            rank -= binomial[c][i];
+        }
+        return mask;
+    };
+    // Next subset with the same number of vertices (Gosper's hack)
+    auto nextSubset = [](size_t mask) {
+        size_t lowest = mask & (~mask + 1);
+        size_t ripple = mask + lowest;
+        return (((ripple ^ mask) >> 2) / lowest) | ripple;
+    };
+
+    const size_t BLOCK = 1 << 12;
+    for (int k = 2; k <= m; k++) {
+        size_t layer = binomial[m][k];
+        auto solveBlock = [&](size_t first, size_t last, int) {
+            size_t mask = unrank(first, k);
+            for (size_t rank = first; rank < last; rank++) {
+                solveSubset(mask);
+                if (rank + 1 < last) {
+                    mask = nextSubset(mask);
+                }
+            }
+        };
+        if (pool != nullptr && layer > BLOCK) {
+            pool->parallelFor(0, layer, BLOCK, solveBlock);
+        }
+        else {
+            solveBlock(0, layer, 0);
+        }
+    }
 
-        if (!destination->isVisited() && current_distance + e->getDistance() < min_distance){
-            destination->setVisited(true);
-            current_distance+= e->getDistance();
-            path.push_back(e);
-
-            branchBoundHelper(start,min_distance,destination,current_distance,path,min_path);
-
-            destination->setVisited(false);
-            current_distance-= e->getDistance();
-            path.pop_back();
+    // Close the cycle
+    size_t full = subsets - 1;
+    Cost best = INF;
+    int last = -1;
+    for (int j = 0; j < m; j++) {
+        Cost c = cost[full * m + j];
+        Cost d = w[static_cast<size_t>(j + 1) * n];
+        if (c != INF && d != INF && c + d < best) {
+            best = c + d;
+            last = j;
         }
     }
+    if (last == -1) {
+        return DistanceMatrix::INF;
+    }
+
+    // Rebuild the order backwards with the parents
+    order.assign(n, 0);
+    size_t mask = full;
+    int j = last;
+    for (int position = m; position >= 1; position--) {
+        order[position] = j + 1;
+        int k = parent[mask * m + j];
+        mask ^= size_t(1) << j;
+        j = k;
+    }
+    return matrix.tourCost(order);
+}
+
+Result Coder::heldKarp(int start_vertex) {
+    return heldKarpSolve(start_vertex, 1);
+}
+
+Result Coder::parallelHeldKarp(int start_vertex, int threads) {
+    return heldKarpSolve(start_vertex, ThreadPool::resolveThreads(threads));
 }
 
-Result Coder::branchBound(int start_vertex) {
+Result Coder::heldKarpSolve(int start_vertex, int threads) {
     // Initialize Timer
     timespec start_real{};
     timespec start_cpu{};
     double elapsed_real, elapsed_cpu;
     startTimer(start_real, start_cpu);
 
-    // Set all vertex to visited false
-    for (Vertex *v: graph->getVertexSet()) {
-        if (v == nullptr) {
-            throw CustomError("NullPtr: vertex v is a null ptr", ERROR);
-        }
-
-        v->setVisited(false);
-    }
-
-    // Initialize distance
-    double min_distance = numeric_limits<double>::max();
-
-    // Start vertex (visited)
     Vertex *start = vertices_table->search(start_vertex);
     if (start == nullptr) {
         throw CustomError("NullPtr: vertex start is a null ptr", ERROR);
     }
-    start->setVisited(true);
+    DistanceMatrix matrix(graph, start);
+    int n = matrix.size();
+    if (n < 2) {
+        return {};
+    }
+
+    size_t cost_size = heldKarpCostSize(matrix);
+    bool integral = cost_size == sizeof(int32_t);
+    size_t needed = heldKarpMemory(n, cost_size);
+    if (needed > memory_limit || n - 1 > UINT8_MAX) {
+        CustomError("Held-Karp needs " + to_string(needed >> 20) + " MiB for " + to_string(n) +
+                    " vertices, the limit is " + to_string(memory_limit >> 20) + " MiB", INFO).what();
+        return {};
+    }
 
-    // Path
-    Tour min_path;
-    Tour path;
+    unique_ptr<ThreadPool> pool = (threads == 1) ? nullptr : make_unique<ThreadPool>(threads);
+    vector<int> order;
+    double distance;
+    if (integral) {
+        distance = heldKarpTable<int32_t>(matrix, order, pool.get());
+    }
+    else if (cost_size == sizeof(double)) {
+        distance = heldKarpTable<double>(matrix, order, pool.get());
+    }
+    else {
+        distance = heldKarpTable<float>(matrix, order, pool.get());
+    }
+    if (distance == DistanceMatrix::INF) {
+        return {};
+    }
 
-    // Backtracking calculation
-    branchBoundHelper(start, min_distance, start, 0, path, min_path);
+    Tour tour = orderToTour(matrix, order);
 
     // Finish Timer
     Time t = stopTimer(start_real, start_cpu, elapsed_real, elapsed_cpu);
-    return {min_path, min_distance, t};
+    if (tour.empty()) {
+        return {};
+    }
+    return {tour, distance, t};
 }
 
+/**
+ * @note Exact solver dispatch
+ */
+Result Coder::exactSolve(int start_vertex) {
+    int n = graph->getNumberOfVertexes();
+    if (n > TinySolver::MAX_SIZE) {
+        if (heldKarpMemory(n) <= memory_limit) {
+            return parallelHeldKarp(start_vertex);
+        }
+        // The 1-tree ignores the direction of the edges, directed graphs are bounded by the assignment
+        Vertex *start = vertices_table->search(start_vertex);
+        if (start == nullptr) {
+            throw CustomError("NullPtr: vertex start is a null ptr", ERROR);
+        }
+        bool symmetric = DistanceMatrix(graph, start).isSymmetric();
+        return parallelBranchBound(start_vertex, symmetric ? ONE_TREE : ASSIGNMENT);
+    }
+
+    // Initialize Timer
+    timespec start_real{};
+    timespec start_cpu{};
+    double elapsed_real, elapsed_cpu;
+    startTimer(start_real, start_cpu);
 
-void Coder::preOrderVisit(Vertex *current, vector<Vertex*>& t) {
-    for (Edge* e : current->getAdj()){
-        if (e->getDestination()->getPath() == e  && !e->getDestination()->isVisited()){
-            t.push_back(e->getDestination());
-            e->getDestination()->setVisited(true);
-            preOrderVisit(e->getDestination(),t);
+    Vertex *start = vertices_table->search(start_vertex);
+    if (start == nullptr) {
+        throw CustomError("NullPtr: vertex start is a null ptr", ERROR);
+    }
+    DistanceMatrix matrix(graph, start);
+    if (matrix.size() < 2) {
+        return {};
+    }
+    vector<int> order(matrix.size());
+    double distance = TinySolver::solve(matrix.row(0), matrix.size(), order.data());
+    if (distance == DistanceMatrix::INF) {
+        return {};
+    }
 
-        }
+    Tour tour = orderToTour(matrix, order);
+
+    // Finish Timer
+    Time t = stopTimer(start_real, start_cpu, elapsed_real, elapsed_cpu);
+    if (tour.empty()) {
+        return {};
     }
+    return {tour, distance, t};
 }
 
+/**
+ * @brief Heap entry of prim, the key is copied at push time so later key updates can't break the heap order
+ */
+struct PrimEntry {
+    double key;
+    Vertex* vertex;
+};
+
 struct Comparator {
-    bool operator()(Vertex* a, Vertex* b) {
-        return a->getKey() > b->getKey();
+    bool operator()(const PrimEntry& a, const PrimEntry& b) const {
+        return a.key > b.key;
     }
 };
 
-Tour Coder::prim(Vertex* start) {
+vector<Vertex*> Coder::prim(Vertex* start) {
+    if (candidateSpanningTree(start)) {
+        return mstPreOrder(start);
+    }
+    if (useDensePrim()) {
+        densePrim(start);
+        return mstPreOrder(start);
+    }
+    if (parallelSpanningTree(start)) {
+        return mstPreOrder(start);
+    }
+
     // Initialization
     double max = numeric_limits<double>::max();
-    priority_queue<Vertex *, vector<Vertex *>, Comparator> pq;
+    priority_queue<PrimEntry, vector<PrimEntry>, Comparator> pq;
 
     // Mst initial values
     for (Vertex *v: graph->getVertexSet()) {
@@ -355,11 +730,11 @@ Tour Coder::prim(Vertex* start) {
     }
 
     start->setKey(0);
-    pq.push(start);
+    pq.push({0, start});
 
     // Calculate mst
     while (!pq.empty()) {
-        Vertex *v = pq.top();
+        Vertex *v = pq.top().vertex;
         pq.pop();
         if (v->isVisited()) continue;
         v->setVisited(true);
@@ -369,156 +744,1374 @@ Tour Coder::prim(Vertex* start) {
                 if (!e->getDestination()->isVisited() && e->getDistance() < e->getDestination()->getKey()) {
                     e->getDestination()->setKey(e->getDistance());
                     e->getDestination()->setPath(e);
-                    pq.push(e->getDestination());
+                    pq.push({e->getDistance(), e->getDestination()});
                 }
             }
         }
-        // Do search in prim with haversine
+        // Do search in prim with the graph metric
         else {
             for (Vertex *v1: graph->getVertexSet()) {
                 if (!v1->isVisited()) {
-                    if (v->getCoordinates() == nullptr || v1->getCoordinates() == nullptr){
+                    if (!canMeasure(v, v1)){
                         continue;
                     }
-                    double distance = haversineDistance(v, v1);
+                    double distance = measureDistance(v, v1);
                     if (distance < v1->getKey()) {
                         Edge* e = graph->addEdge(v, v1, distance);
                         v1->setKey(distance);
                         v1->setPath(e);
-                        pq.push(v1);
+                        pq.push({distance, v1});
                     }
                 }
             }
         }
     }
 
-    // Visit mst in pre-order visit
-    for (Vertex* v : graph->getVertexSet()){
-        if (v == nullptr){
-            throw CustomError("Null Ptr: vertex v is a null ptr",ERROR);
+    return mstPreOrder(start);
+}
+
+vector<Vertex*> Coder::mstPreOrder(Vertex* start) {
+    // Every version of prim ends here: the visited flags it set are cleared for the algorithms that run next
+    graph->resetVisited();
+
+    // Child arrays of the tree left by prim (the path of a reached vertex is the edge from its parent)
+    double max = numeric_limits<double>::max();
+    vector<Vertex*> vertices;
+    unordered_map<const Vertex*, int> index;
+    for (Vertex* v : graph->getVertexSet()) {
+        if (v == nullptr) {
+            throw CustomError("Null Ptr: vertex v is a null ptr", ERROR);
         }
-        v->setVisited(false);
+        index[v] = static_cast<int>(vertices.size());
+        vertices.push_back(v);
     }
-    vector<Vertex*> mst_v;
-    start->setVisited(true);
-    mst_v.push_back(start);
-    preOrderVisit(start,mst_v);
-
-    // Get the mst (convert vector<Vertex*> to Tour)
-    Tour mst;
-    for (int i = 0; i < mst_v.size() - 1; i++){
-        Vertex* origin = mst_v[i];
-        Vertex* destination = mst_v[i+1];
-        if (origin == nullptr || destination == nullptr){
-            throw CustomError("Null Ptr: origin/destination is a null ptr",ERROR);
-        }
-        bool find = false;
-        for (Edge* e : origin->getAdj()) {
-            if (e == nullptr){
-                throw CustomError("Null Ptr: edge is a null ptr",ERROR);
-            }
-            if (e->getDestination() == destination) {
-                find = true;
-                mst.push_back(e);
-                break;
+    int n = static_cast<int>(vertices.size());
+    vector<int> parent(n, -1);
+    vector<int> first_child(n + 1, 0);
+    for (int i = 0; i < n; i++) {
+        Edge* e = vertices[i]->getPath();
+        if (vertices[i] != start && vertices[i]->getKey() != max && e != nullptr) {
+            auto it = index.find(e->getOrigin());
+            if (it != index.end()) {
+                parent[i] = it->second;
+                first_child[parent[i] + 1]++;
             }
         }
-        if (!find){
-            if (origin->getCoordinates() != nullptr || destination->getCoordinates() != nullptr) {
-                double distance = haversineDistance(origin, destination);
-                Edge *e = graph->addEdge(origin, destination, distance);
-                mst.push_back(e);
-            }
+    }
+    for (int i = 0; i < n; i++) {
+        first_child[i + 1] += first_child[i];
+    }
+    vector<int> children(first_child[n]);
+    vector<int> filled(first_child.begin(), first_child.end() - 1);
+    for (int i = 0; i < n; i++) {
+        if (parent[i] != -1) {
+            children[filled[parent[i]]++] = i;
         }
     }
-    return mst;
-}
-
-
-Result Coder::triangularApproximation(int start_vertex) {
-    // Start timer
-    timespec start_real{};
-    timespec start_cpu{};
-    double elapsed_real, elapsed_cpu;
-    startTimer(start_real, start_cpu);
 
-    // Find first vertex
-    Vertex* start = vertices_table->search(start_vertex);
-    if (start == nullptr){
-        throw CustomError("Null Ptr: start vertex is a null ptr",ERROR);
+    // Iterative pre-order walk, children are pushed in reverse so that the first one is visited first
+    vector<Vertex*> order;
+    vector<int> stack = {index.at(start)};
+    vector<char> visited(n, false);
+    while (!stack.empty()) {
+        int x = stack.back();
+        stack.pop_back();
+        if (visited[x]) {
+            continue;
+        }
+        visited[x] = true;
+        order.push_back(vertices[x]);
+        for (int c = first_child[x + 1] - 1; c >= first_child[x]; c--) {
+            stack.push_back(children[c]);
+        }
     }
+    return order;
+}
 
-    // Find mst
-    Tour mst = prim(start);
-
-    // If mst is empty, there is no path found
-    if (mst.empty()){
-        Time time = stopTimer(start_real,start_cpu,elapsed_real,elapsed_cpu);
-        return {mst,0,time};
+bool Coder::useDensePrim() const {
+    double n = graph->getNumberOfVertexes();
+    if (n < 2) {
+        return false;
     }
-
-    // The result could be an invalid spanning tree.
-    if (mst.size() != graph->getNumberOfVertexes()-1){
-        return {};
+    double edges = 0;
+    for (Vertex* v : graph->getVertexSet()) {
+        edges += (v->getOutDegree() == 0) ? n - 1 : v->getOutDegree();
     }
+    return edges * log2(n) >= n * n;
+}
 
-    for (Vertex* v : graph->getVertexSet()){
-        v->setVisited(false);
+/**
+ * @brief Position of the smallest key (the first one on ties)
+ * @note Two SSE2 accumulators find the minimum, a second pass finds where it is
+ * @Complexity - O(n)
+ */
+static int minimumKey(const double* keys, int n) {
+    double best = numeric_limits<double>::infinity();
+    int i = 0;
+#if defined(__SSE2__)
+    __m128d low = _mm_set1_pd(best);
+    __m128d high = low;
+    for (; i + 4 <= n; i += 4) {
+        low = _mm_min_pd(low, _mm_loadu_pd(keys + i));
+        high = _mm_min_pd(high, _mm_loadu_pd(keys + i + 2));
     }
-
-    for (Edge* e : mst){
-        if (e->getOrigin()->isVisited()){
-            return {};
-        }
-        e->getOrigin()->setVisited(true);
+    low = _mm_min_pd(low, high);
+    low = _mm_min_sd(low, _mm_unpackhi_pd(low, low));
+    best = _mm_cvtsd_f64(low);
+#endif
+    for (; i < n; i++) {
+        best = min(best, keys[i]);
     }
-    Vertex* last_vertex = mst.back()->getDestination();
-    if (last_vertex->isVisited()){
-        return {};
+    for (i = 0; i < n; i++) {
+        if (keys[i] == best) {
+            return i;
+        }
     }
-    last_vertex->setVisited(true);
+    return 0;
+}
 
-    for (Vertex* v : graph->getVertexSet()){
-        if (!v->isVisited()){
-            return {};
-        }
-        v->setVisited(false);
+void Coder::densePrim(Vertex* start) {
+    double max = numeric_limits<double>::max();
+    double in_tree = numeric_limits<double>::infinity();
+
+    vector<Vertex*> vertices = startFirst(start);
+    int n = static_cast<int>(vertices.size());
+    unordered_map<const Vertex*, int> index;
+    for (int i = 0; i < n; i++) {
+        index[vertices[i]] = i;
     }
 
-    bool findEdge = false;
-    // Find edge for completing the cycle
-    for (Edge* e : last_vertex->getAdj()){
-        if (e == nullptr){
-            throw CustomError("Null Ptr: edge is a null ptr",ERROR);
-        }
-        if (e->getDestination() == start){
-            findEdge = true;
-            mst.push_back(e);
+    // keys holds infinity once a vertex is in the tree, so it never wins the reduction again
+    vector<double> keys(n, max);
+    vector<double> tree_keys(n, max);
+    vector<int> parent(n, -1);
+    vector<Edge*> parent_edge(n, nullptr);
+    keys[0] = 0;
+    tree_keys[0] = 0;
+
+    for (int step = 0; step < n; step++) {
+        int u = minimumKey(keys.data(), n);
+        if (keys[u] == max || keys[u] == in_tree) {
             break;
         }
-    }
+        tree_keys[u] = keys[u];
+        keys[u] = in_tree;
+
+        Vertex* v = vertices[u];
+        vector<Edge*> adj = v->getAdj();
+        if (!adj.empty()) {
+            for (Edge* e : adj) {
+                auto it = index.find(e->getDestination());
+                if (it == index.end()) {
+                    continue;
+                }
+                int w = it->second;
+                if (keys[w] != in_tree && e->getDistance() < keys[w]) {
+                    keys[w] = e->getDistance();
+                    parent[w] = u;
+                    parent_edge[w] = e;
+                }
+            }
+        }
+        // Do search in prim with the graph metric
+        else {
+            for (int w = 0; w < n; w++) {
+                if (keys[w] == in_tree || !canMeasure(v, vertices[w])) {
+                    continue;
+                }
+                double distance = measureDistance(v, vertices[w]);
+                if (distance < keys[w]) {
+                    keys[w] = distance;
+                    parent[w] = u;
+                    parent_edge[w] = nullptr;
+                }
+            }
+        }
+    }
 
-    // If there is no edge try using coordinates
-    if (!findEdge){
-        if (last_vertex->getCoordinates() == nullptr || start->getCoordinates() == nullptr){
-            return {};
+    // Same vertex state as the heap version, the measured tree edges become graph edges in both directions
+    for (int i = 0; i < n; i++) {
+        Vertex* v = vertices[i];
+        v->setVisited(keys[i] == in_tree);
+        v->setKey(tree_keys[i]);
+        if (parent[i] != -1 && keys[i] == in_tree) {
+            Edge* e = parent_edge[i];
+            if (e == nullptr) {
+                e = graph->addEdge(vertices[parent[i]], v, tree_keys[i]);
+                graph->addEdge(v, vertices[parent[i]], measureDistance(v, vertices[parent[i]]));
+            }
+            if (e == nullptr) {
+                e = graph->getEdgeFromGraph(vertices[parent[i]], v);
+            }
+            v->setPath(e);
         }
-        else{
-            double distance = haversineDistance(last_vertex,start);
-            Edge* cycle_edge = graph->addEdge(last_vertex,start,distance);
-            mst.push_back(cycle_edge);
+    }
+}
+
+bool Coder::parallelSpanningTree(Vertex* start) {
+    vector<Vertex*> vertices = startFirst(start);
+    int n = static_cast<int>(vertices.size());
+    vector<size_t> offsets(n + 1, 0);
+    for (int i = 0; i < n; i++) {
+        if (vertices[i]->getOutDegree() == 0) {
+            return false;
+        }
+        offsets[i + 1] = offsets[i] + vertices[i]->getOutDegree();
+    }
+    if (offsets[n] < PARALLEL_MST_EDGES || ThreadPool::resolveThreads(0) < 2) {
+        return false;
+    }
+    unordered_map<const Vertex*, int> index;
+    for (int i = 0; i < n; i++) {
+        index[vertices[i]] = i;
+    }
+
+    // Out edges of every vertex sorted by destination, the position of an edge is its tie break in Borůvka
+    struct OutEdge {
+        int destination;
+        Edge* edge;
+    };
+    vector<OutEdge> rows(offsets[n]);
+    ThreadPool pool(0);
+    atomic<bool> valid{true};
+    pool.parallelFor(0, n, 256, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; i++) {
+            vector<Edge*> adj = vertices[i]->getAdj();
+            if (adj.size() != offsets[i + 1] - offsets[i]) {
+                valid.store(false);
+                return;
+            }
+            size_t position = offsets[i];
+            for (Edge* e : adj) {
+                auto it = index.find(e->getDestination());
+                if (it == index.end()) {
+                    valid.store(false);
+                    return;
+                }
+                rows[position++] = {it->second, e};
+            }
+            sort(rows.begin() + static_cast<long>(offsets[i]), rows.begin() + static_cast<long>(offsets[i + 1]),
+                 [](const OutEdge& a, const OutEdge& b) { return a.destination < b.destination; });
+        }
+    });
+    if (!valid.load()) {
+        return false;
+    }
+
+    // Every edge u -> v (u < v) with an opposite v -> u of the same distance is one undirected edge, the others are
+    // left as self loops so that positions stay the same
+    vector<TreeEdge> edges(rows.size());
+    vector<Edge*> opposite(rows.size(), nullptr);
+    pool.parallelFor(0, n, 256, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; i++) {
+            int u = static_cast<int>(i);
+            for (size_t p = offsets[u]; p < offsets[u + 1]; p++) {
+                int v = rows[p].destination;
+                double distance = rows[p].edge->getDistance();
+                auto first = rows.begin() + static_cast<long>(offsets[v]);
+                auto last = rows.begin() + static_cast<long>(offsets[v + 1]);
+                auto it = lower_bound(first, last, u, [](const OutEdge& e, int d) { return e.destination < d; });
+                if (it == last || it->destination != u || it->edge->getDistance() != distance) {
+                    valid.store(false);
+                    return;
+                }
+                edges[p] = (u < v) ? TreeEdge{u, v, distance} : TreeEdge{u, u, distance};
+                opposite[p] = it->edge;
+            }
+        }
+    });
+    if (!valid.load()) {
+        return false;
+    }
+
+    vector<int> forest = SpanningTree::boruvka(n, edges, pool.getThreads());
+
+    rootTree(vertices, edges, forest, [&](int p, int x, int) { return (edges[p].u == x) ? rows[p].edge : opposite[p]; });
+    return true;
+}
+
+bool Coder::candidateSpanningTree(Vertex* start) {
+    const Metric* metric = graph->getMetric();
+    if (metric == nullptr || graph->getNumberOfVertexes() < CANDIDATE_MST_VERTICES) {
+        return false;
+    }
+
+    vector<Vertex*> vertices = startFirst(start);
+    int n = static_cast<int>(vertices.size());
+    for (Vertex* v : vertices) {
+        if (v->getOutDegree() != 0) {
+            return false;
+        }
+    }
+    vector<Point> points;
+    if (!metricPoints(vertices, points)) {
+        return false;
+    }
+
+    // Candidate graph: every vertex with its nearest neighbours, measured by the metric
+    KdTree tree(std::move(points));
+    vector<TreeEdge> edges = nearestEdges(vertices, tree, vector<char>(n, true));
+    ThreadPool pool(0);
+
+    // Pieces of the candidate graph (clusters) are joined by their cheapest connections, as Borůvka rounds over them
+    vector<int> forest = SpanningTree::boruvka(n, edges, pool.getThreads());
+    while (static_cast<int>(forest.size()) < n - 1) {
+        vector<int> labels(n);
+        iota(labels.begin(), labels.end(), 0);
+        auto find = [&labels](int x) {
+            while (labels[x] != x) {
+                x = labels[x] = labels[labels[x]];
+            }
+            return x;
+        };
+        for (int p : forest) {
+            labels[find(edges[p].u)] = find(edges[p].v);
+        }
+        for (int i = 0; i < n; i++) {
+            labels[i] = find(i);
+        }
+
+        vector<int> node_labels = tree.nodeLabels(labels);
+        vector<int> closest(n, -1);
+        vector<double> closest_distance(n, numeric_limits<double>::infinity());
+        pool.parallelFor(0, n, 256, [&](size_t begin, size_t end, int) {
+            for (size_t i = begin; i < end; i++) {
+                closest[i] = tree.nearestOther(static_cast<int>(i), labels, node_labels);
+                if (closest[i] != -1) {
+                    closest_distance[i] = metric->distance(vertices[i], vertices[closest[i]]);
+                }
+            }
+        });
+        vector<int> cheapest(n, -1);
+        for (int i = 0; i < n; i++) {
+            int& c = cheapest[labels[i]];
+            if (closest[i] != -1 && (c == -1 || closest_distance[i] < closest_distance[c])) {
+                c = i;
+            }
+        }
+        size_t before = edges.size();
+        for (int i : cheapest) {
+            if (i != -1) {
+                edges.push_back({min(i, closest[i]), max(i, closest[i]), closest_distance[i]});
+            }
+        }
+        if (edges.size() == before) {
+            return false;
+        }
+        forest = SpanningTree::boruvka(n, edges, pool.getThreads());
+    }
+
+    // Tree edges become graph edges in both directions, so a later prim finds the same tree from any start
+    rootTree(vertices, edges, forest, [&](int p, int x, int y) {
+        Edge* e = graph->addEdge(vertices[x], vertices[y], edges[p].distance);
+        graph->addEdge(vertices[y], vertices[x], edges[p].distance);
+        return (e != nullptr) ? e : graph->getEdgeFromGraph(vertices[x], vertices[y]);
+    });
+    return true;
+}
+
+vector<Vertex*> Coder::startFirst(Vertex* start) const {
+    vector<Vertex*> vertices = {start};
+    for (Vertex* v : graph->getVertexSet()) {
+        if (v == nullptr) {
+            throw CustomError("Null Ptr: vertex v is a null ptr", ERROR);
+        }
+        if (v != start) {
+            vertices.push_back(v);
+        }
+    }
+    return vertices;
+}
+
+bool Coder::metricPoints(const vector<Vertex*>& vertices, vector<Point>& points) const {
+    const Metric* metric = graph->getMetric();
+    points.assign(vertices.size(), Point{0, 0, 0});
+    if (metric == nullptr) {
+        return false;
+    }
+    for (size_t i = 0; i < vertices.size(); i++) {
+        if (!metric->getPoint(vertices[i], points[i].data())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+vector<TreeEdge> Coder::nearestEdges(const vector<Vertex*>& vertices, const KdTree& tree, const vector<char>& selected) {
+    const Metric* metric = graph->getMetric();
+    size_t n = vertices.size();
+    vector<TreeEdge> edges(n * CANDIDATE_NEIGHBOURS, TreeEdge{0, 0, 0});
+    ThreadPool pool(0);
+    pool.parallelFor(0, n, 256, [&](size_t begin, size_t end, int) {
+        vector<int> neighbours;
+        for (size_t i = begin; i < end; i++) {
+            if (!selected[i]) {
+                continue;
+            }
+            tree.nearest(static_cast<int>(i), CANDIDATE_NEIGHBOURS, neighbours);
+            for (size_t c = 0; c < neighbours.size(); c++) {
+                int u = static_cast<int>(i), v = neighbours[c];
+                Edge* e = (vertices[u]->getOutDegree() != 0) ? graph->getEdgeFromGraph(vertices[u], vertices[v]) : nullptr;
+                double distance = (e != nullptr) ? e->getDistance() : metric->distance(vertices[u], vertices[v]);
+                edges[i * CANDIDATE_NEIGHBOURS + c] = {min(u, v), max(u, v), distance};
+            }
         }
+    });
+    // Unused slots are self loops, drop them
+    edges.erase(remove_if(edges.begin(), edges.end(), [](const TreeEdge& e) { return e.u == e.v; }), edges.end());
+    return edges;
+}
+
+void Coder::rootTree(const vector<Vertex*>& vertices, const vector<TreeEdge>& edges, const vector<int>& forest,
+                     const function<Edge*(int, int, int)>& edge) {
+    int n = static_cast<int>(vertices.size());
+    vector<vector<int>> tree(n);
+    for (int p : forest) {
+        tree[edges[p].u].push_back(p);
+        tree[edges[p].v].push_back(p);
+    }
+    double max = numeric_limits<double>::max();
+    for (Vertex* v : vertices) {
+        v->setVisited(false);
+        v->setKey(max);
+    }
+    vertices[0]->setVisited(true);
+    vertices[0]->setKey(0);
+    vector<int> queue = {0};
+    for (size_t head = 0; head < queue.size(); head++) {
+        int x = queue[head];
+        for (int p : tree[x]) {
+            int y = (edges[p].u == x) ? edges[p].v : edges[p].u;
+            if (vertices[y]->isVisited()) {
+                continue;
+            }
+            Edge* e = edge(p, x, y);
+            vertices[y]->setVisited(true);
+            vertices[y]->setKey(e->getDistance());
+            vertices[y]->setPath(e);
+            queue.push_back(y);
+        }
+    }
+}
+
+Result Coder::triangularApproximation(int start_vertex) {
+    // Start timer
+    timespec start_real{};
+    timespec start_cpu{};
+    double elapsed_real, elapsed_cpu;
+    startTimer(start_real, start_cpu);
+
+    // Find first vertex
+    Vertex* start = vertices_table->search(start_vertex);
+    if (start == nullptr){
+        throw CustomError("Null Ptr: start vertex is a null ptr",ERROR);
+    }
+
+    // Find mst, its pre-order walk shortcuts the closed walk around the tree
+    vector<Vertex*> order = prim(start);
+    if (order.size() < 2) {
+        Time time = stopTimer(start_real,start_cpu,elapsed_real,elapsed_cpu);
+        return {{},0,time};
+    }
+
+    // The result could be an invalid spanning tree.
+    if (static_cast<int>(order.size()) != graph->getNumberOfVertexes()){
+        return {};
+    }
+
+    // Close the cycle, missing edges are measured with the metric
+    Tour tour = verticesToTour(order);
+    if (tour.empty()){
+        return {};
     }
 
     // Get the result
     double distance = 0.0;
-    for (Edge* e : mst){
+    for (Edge* e : tour){
+        distance += e->getDistance();
+    }
+
+    // Finish timer
+    Time time = stopTimer(start_real,start_cpu,elapsed_real,elapsed_cpu);
+    return {tour,distance,time};
+}
+
+Result Coder::christofides(int start_vertex, MATCHING_TYPE matching) {
+    // Start timer
+    timespec start_real{};
+    timespec start_cpu{};
+    double elapsed_real, elapsed_cpu;
+    startTimer(start_real, start_cpu);
+
+    Vertex* start = vertices_table->search(start_vertex);
+    if (start == nullptr){
+        throw CustomError("Null Ptr: start vertex is a null ptr",ERROR);
+    }
+
+    vector<Vertex*> vertices = startFirst(start);
+    int n = static_cast<int>(vertices.size());
+    if (n < 2) {
+        return {};
+    }
+    unordered_map<const Vertex*, int> index;
+    for (int i = 0; i < n; i++) {
+        index[vertices[i]] = i;
+    }
+
+    // Tree edges: prim leaves the edge from the parent as the path of every vertex it reached
+    prim(start);
+    vector<pair<int, int>> edges;
+    vector<int> degree(n, 0);
+    for (int i = 1; i < n; i++) {
+        Edge* e = vertices[i]->getPath();
+        if (vertices[i]->getKey() == numeric_limits<double>::max() || e == nullptr) {
+            return {};
+        }
+        int parent = index.at(e->getOrigin());
+        edges.emplace_back(parent, i);
+        degree[parent]++;
+        degree[i]++;
+    }
+
+    // Odd degree vertices, matched by their edge (cheapest direction) or else by the graph metric
+    vector<int> odd;
+    vector<int> odd_position(n, -1);
+    for (int i = 0; i < n; i++) {
+        if (degree[i] % 2 != 0) {
+            odd_position[i] = static_cast<int>(odd.size());
+            odd.push_back(i);
+        }
+    }
+    auto k = static_cast<uint64_t>(odd.size());
+    unordered_map<uint64_t, double> odd_edges;
+    for (int a = 0; a < static_cast<int>(k); a++) {
+        for (const Edge* e : vertices[odd[a]]->getAdj()) {
+            int b = odd_position[index.at(e->getDestination())];
+            if (b != -1 && b != a) {
+                uint64_t key = min(a, b) * k + max(a, b);
+                auto it = odd_edges.find(key);
+                if (it == odd_edges.end() || e->getDistance() < it->second) {
+                    odd_edges[key] = e->getDistance();
+                }
+            }
+        }
+    }
+    const Metric* metric = graph->getMetric();
+    PairDistance distance = [&](int a, int b) {
+        auto it = odd_edges.find(min(a, b) * k + max(a, b));
+        if (it != odd_edges.end()) {
+            return it->second;
+        }
+        Vertex* x = vertices[odd[a]];
+        Vertex* y = vertices[odd[b]];
+        return metric->canMeasure(x, y) ? metric->distance(x, y) : numeric_limits<double>::infinity();
+    };
+
+    if (matching == OPTIMAL_MATCHING && Matching::optimalMemory(static_cast<int>(k)) > memory_limit) {
+        CustomError("The optimal matching of " + to_string(k) + " vertices does not fit the memory limit, using the greedy one", INFO).what();
+        matching = GREEDY_MATCHING;
+    }
+    else if (matching == OPTIMAL_MATCHING && static_cast<int>(k) > Matching::OPTIMAL_MAX_SIZE) {
+        CustomError("The optimal matching of " + to_string(k) + " vertices would take too long, using the greedy one", INFO).what();
+        matching = GREEDY_MATCHING;
+    }
+    vector<int> mate;
+    bool matched = (matching == OPTIMAL_MATCHING) ? Matching::optimal(static_cast<int>(k), distance, mate)
+                                                  : Matching::greedy(static_cast<int>(k), distance, mate);
+    if (!matched) {
+        return {};
+    }
+    for (int a = 0; a < static_cast<int>(k); a++) {
+        if (a < mate[a]) {
+            edges.emplace_back(odd[a], odd[mate[a]]);
+        }
+    }
+
+    // Euler tour of the tree + matching (Hierholzer with an explicit stack), shortcut at the first visit of a vertex
+    vector<vector<int>> incident(n);
+    for (int i = 0; i < static_cast<int>(edges.size()); i++) {
+        incident[edges[i].first].push_back(i);
+        incident[edges[i].second].push_back(i);
+    }
+    vector<char> used(edges.size(), false);
+    vector<size_t> next_edge(n, 0);
+    vector<int> circuit;
+    vector<int> stack = {0};
+    while (!stack.empty()) {
+        int v = stack.back();
+        while (next_edge[v] < incident[v].size() && used[incident[v][next_edge[v]]]) {
+            next_edge[v]++;
+        }
+        if (next_edge[v] == incident[v].size()) {
+            circuit.push_back(v);
+            stack.pop_back();
+            continue;
+        }
+        int e = incident[v][next_edge[v]];
+        used[e] = true;
+        stack.push_back(edges[e].first == v ? edges[e].second : edges[e].first);
+    }
+    reverse(circuit.begin(), circuit.end());
+
+    vector<char> visited(n, false);
+    vector<Vertex*> order;
+    for (int v : circuit) {
+        if (!visited[v]) {
+            visited[v] = true;
+            order.push_back(vertices[v]);
+        }
+    }
+
+    Tour tour = verticesToTour(order);
+    if (tour.empty()) {
+        return {};
+    }
+    double total = 0;
+    for (Edge* e : tour) {
+        total += e->getDistance();
+    }
+
+    // Finish timer
+    Time time = stopTimer(start_real,start_cpu,elapsed_real,elapsed_cpu);
+    return {tour, total, time};
+}
+
+/**
+ * @brief Sorts with a pool: chunks are sorted in parallel, then merged in pairs (every round of merges in parallel)
+ */
+template<typename T, typename Less>
+static void parallelSort(vector<T>& items, Less less, ThreadPool& pool) {
+    size_t size = items.size();
+    auto threads = static_cast<size_t>(pool.getThreads());
+    size_t chunk = max<size_t>(1 << 14, (size + threads - 1) / threads);
+    size_t chunks = (size + chunk - 1) / chunk;
+    pool.parallelFor(0, chunks, 1, [&](size_t begin, size_t end, int) {
+        for (size_t c = begin; c < end; c++) {
+            sort(items.begin() + static_cast<long>(c * chunk), items.begin() + static_cast<long>(min(size, (c + 1) * chunk)),
+                 less);
+        }
+    });
+    vector<T> buffer(size);
+    for (size_t width = chunk; width < size; width *= 2) {
+        size_t pairs = (size + 2 * width - 1) / (2 * width);
+        pool.parallelFor(0, pairs, 1, [&](size_t begin, size_t end, int) {
+            for (size_t p = begin; p < end; p++) {
+                auto low = static_cast<long>(p * 2 * width);
+                auto middle = static_cast<long>(min(size, p * 2 * width + width));
+                auto high = static_cast<long>(min(size, p * 2 * width + 2 * width));
+                merge(items.begin() + low, items.begin() + middle, items.begin() + middle, items.begin() + high,
+                      buffer.begin() + low, less);
+            }
+        });
+        items.swap(buffer);
+    }
+}
+
+Result Coder::greedyEdge(int start_vertex) {
+    // Start timer
+    timespec start_real{};
+    timespec start_cpu{};
+    double elapsed_real, elapsed_cpu;
+    startTimer(start_real, start_cpu);
+
+    Vertex* start = vertices_table->search(start_vertex);
+    if (start == nullptr){
+        throw CustomError("Null Ptr: start vertex is a null ptr",ERROR);
+    }
+    vector<Vertex*> vertices = startFirst(start);
+    int n = static_cast<int>(vertices.size());
+    if (n < 2) {
+        return {};
+    }
+    unordered_map<const Vertex*, int> index;
+    for (int i = 0; i < n; i++) {
+        index[vertices[i]] = i;
+    }
+
+    // Candidates: the edges of the graph, plus the nearest neighbours of the vertices with few edges
+    vector<TreeEdge> edges;
+    vector<char> selected(n, false);
+    bool few_edges = false;
+    for (int i = 0; i < n; i++) {
+        for (Edge* e : vertices[i]->getAdj()) {
+            auto it = index.find(e->getDestination());
+            if (it != index.end() && it->second != i) {
+                edges.push_back({min(i, it->second), max(i, it->second), e->getDistance()});
+            }
+        }
+        selected[i] = vertices[i]->getOutDegree() < CANDIDATE_NEIGHBOURS;
+        few_edges = few_edges || selected[i];
+    }
+    vector<Point> points;
+    bool has_points = metricPoints(vertices, points);
+    if (few_edges && has_points) {
+        KdTree tree(points);
+        vector<TreeEdge> nearest = nearestEdges(vertices, tree, selected);
+        edges.insert(edges.end(), nearest.begin(), nearest.end());
+    }
+
+    // Cheapest first (ties by position), an edge joins two fragment ends of different fragments
+    ThreadPool pool(0);
+    vector<int> fragment(n);
+    iota(fragment.begin(), fragment.end(), 0);
+    auto find = [&fragment](int x) {
+        while (fragment[x] != x) {
+            x = fragment[x] = fragment[fragment[x]];
+        }
+        return x;
+    };
+    vector<array<int, 2>> link(n, {-1, -1});
+    vector<int> degree(n, 0);
+    int fragments = n;
+    auto grow = [&](const vector<TreeEdge>& candidates) {
+        vector<int> sorted(candidates.size());
+        iota(sorted.begin(), sorted.end(), 0);
+        parallelSort(sorted, [&candidates](int a, int b) {
+            return candidates[a].distance < candidates[b].distance ||
+                   (candidates[a].distance == candidates[b].distance && a < b);
+        }, pool);
+        int joined = 0;
+        for (int p : sorted) {
+            int u = candidates[p].u, v = candidates[p].v;
+            if (degree[u] == 2 || degree[v] == 2) {
+                continue;
+            }
+            int fu = find(u), fv = find(v);
+            if (fu == fv) {
+                continue;
+            }
+            fragment[fu] = fv;
+            link[u][degree[u]++] = v;
+            link[v][degree[v]++] = u;
+            joined++;
+        }
+        fragments -= joined;
+        return joined;
+    };
+    grow(edges);
+
+    // Fragment ends are joined the same way over the nearest neighbours among the ends, while that makes progress
+    while (has_points && fragments > 1) {
+        vector<int> ends;
+        vector<Vertex*> end_vertices;
+        vector<Point> end_points;
+        for (int i = 0; i < n; i++) {
+            if (degree[i] < 2) {
+                ends.push_back(i);
+                end_vertices.push_back(vertices[i]);
+                end_points.push_back(points[i]);
+            }
+        }
+        KdTree tree(std::move(end_points));
+        vector<TreeEdge> candidates = nearestEdges(end_vertices, tree, vector<char>(ends.size(), true));
+        for (TreeEdge& e : candidates) {
+            e.u = ends[e.u];
+            e.v = ends[e.v];
+        }
+        if (grow(candidates) == 0) {
+            break;
+        }
+    }
+
+    // Ends of every fragment (a single vertex is both ends)
+    vector<array<int, 2>> ends(n, {-1, -1});
+    for (int i = 0; i < n; i++) {
+        if (degree[i] < 2) {
+            array<int, 2>& e = ends[find(i)];
+            e[(e[0] == -1) ? 0 : 1] = i;
+            if (degree[i] == 0) {
+                e[1] = i;
+            }
+        }
+    }
+    auto walk = [&link](int from, vector<int>& order) {
+        int previous = -1;
+        int x = from;
+        while (x != -1) {
+            order.push_back(x);
+            int next = (link[x][0] != previous) ? link[x][0] : link[x][1];
+            previous = x;
+            x = next;
+        }
+        return previous;
+    };
+    auto joinDistance = [&](int a, int b) {
+        Edge* e = graph->getEdgeFromGraph(vertices[a], vertices[b]);
+        if (e != nullptr) {
+            return e->getDistance();
+        }
+        return canMeasure(vertices[a], vertices[b]) ? measureDistance(vertices[a], vertices[b])
+                                                    : numeric_limits<double>::infinity();
+    };
+
+    // Fragments left chained nearest end first, from the fragment of start
+    vector<int> order;
+    order.reserve(n);
+    int tail = walk(ends[find(0)][0], order);
+    vector<int> left;
+    for (int i = 0; i < n; i++) {
+        if (find(i) == i && i != find(0)) {
+            left.push_back(i);
+        }
+    }
+    while (!left.empty()) {
+        double best = numeric_limits<double>::infinity();
+        size_t best_fragment = 0;
+        int best_end = -1;
+        for (size_t f = 0; f < left.size(); f++) {
+            for (int end : ends[left[f]]) {
+                double d = joinDistance(tail, end);
+                if (d < best) {
+                    best = d;
+                    best_fragment = f;
+                    best_end = end;
+                }
+            }
+        }
+        if (best_end == -1) {
+            return {}; // No solution found
+        }
+        tail = walk(best_end, order);
+        left[best_fragment] = left.back();
+        left.pop_back();
+    }
+
+    // Start first
+    rotate(order.begin(), find_if(order.begin(), order.end(), [](int v) { return v == 0; }), order.end());
+    vector<Vertex*> cycle;
+    cycle.reserve(n);
+    for (int v : order) {
+        cycle.push_back(vertices[v]);
+    }
+    Tour tour = verticesToTour(cycle);
+    if (tour.empty()) {
+        return {};
+    }
+    double distance = 0;
+    for (Edge* e : tour) {
+        distance += e->getDistance();
+    }
+
+    // Finish timer
+    Time time = stopTimer(start_real,start_cpu,elapsed_real,elapsed_cpu);
+    return {tour, distance, time};
+}
+
+/**
+ * @brief Spreads the low bits of x so that dims - 1 zero bits separate them (Morton order)
+ */
+static uint64_t spreadBits(uint64_t x, int dims) {
+    if (dims == 2) {
+        x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+        x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+        x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+        x = (x | (x << 2)) & 0x3333333333333333ull;
+        return (x | (x << 1)) & 0x5555555555555555ull;
+    }
+    x = (x | (x << 32)) & 0x001F00000000FFFFull;
+    x = (x | (x << 16)) & 0x001F0000FF0000FFull;
+    x = (x | (x << 8)) & 0x100F00F00F00F00Full;
+    x = (x | (x << 4)) & 0x10C30C30C30C30C3ull;
+    return (x | (x << 2)) & 0x1249249249249249ull;
+}
+
+/**
+ * @brief Position of a cell on the Hilbert curve of dims (2 or 3) dimensions and bits bits per axis (Skilling,
+ * "Programming the Hilbert curve", 2004): the axes are turned into the transposed index in place, then its bits are
+ * interleaved
+ * @param x - cell coordinates, overwritten
+ */
+static uint64_t hilbertIndex(uint32_t* x, int dims, int bits) {
+    // Branch free: the bits are random, a branch per bit would mostly be mispredicted
+    for (int b = bits - 1; b > 0; b--) {
+        uint32_t p = (1u << b) - 1;
+        for (int i = 0; i < dims; i++) {
+            uint32_t set = 0u - ((x[i] >> b) & 1u);
+            uint32_t t = (x[0] ^ x[i]) & p & ~set;
+            x[0] ^= (p & set) | t;
+            x[i] ^= t;
+        }
+    }
+    for (int i = 1; i < dims; i++) {
+        x[i] ^= x[i - 1];
+    }
+    uint32_t t = 0;
+    for (int b = bits - 1; b > 0; b--) {
+        t ^= (0u - ((x[dims - 1] >> b) & 1u)) & ((1u << b) - 1);
+    }
+    uint64_t index = 0;
+    for (int i = 0; i < dims; i++) {
+        index |= spreadBits(x[i] ^ t, dims) << (dims - 1 - i);
+    }
+    return index;
+}
+
+Result Coder::hilbertCurve(int start_vertex) {
+    // Start timer
+    timespec start_real{};
+    timespec start_cpu{};
+    double elapsed_real, elapsed_cpu;
+    startTimer(start_real, start_cpu);
+
+    Vertex* start = vertices_table->search(start_vertex);
+    if (start == nullptr){
+        throw CustomError("Null Ptr: start vertex is a null ptr",ERROR);
+    }
+    vector<Vertex*> vertices = startFirst(start);
+    size_t n = vertices.size();
+    vector<Point> points;
+    if (n < 2 || !metricPoints(vertices, points)) {
+        CustomError("The space filling curve needs coordinates for every vertex", INFO).what();
+        return {};
+    }
+
+    // Bounding box, planar points (z = 0) use the 2D curve, points on the sphere the 3D one
+    Point low = points[0], high = points[0];
+    for (const Point& p : points) {
+        for (int a = 0; a < 3; a++) {
+            low[a] = min(low[a], p[a]);
+            high[a] = max(high[a], p[a]);
+        }
+    }
+    int dims = (high[2] > low[2]) ? 3 : 2;
+    // The points lie on a surface, 2^16 cells of it per point separate them well even when clustered
+    int bits = min(63 / dims, static_cast<int>(ceil(log2(static_cast<double>(n)) / 2)) + 8);
+    double extent = max({high[0] - low[0], high[1] - low[1], high[2] - low[2]});
+    double scale = (extent > 0) ? static_cast<double>((1ull << bits) - 1) / extent : 0;
+
+    // Curve position of every vertex, ties keep the input order
+    ThreadPool pool(0);
+    vector<pair<uint64_t, int>> keys(n);
+    pool.parallelFor(0, n, 4096, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; i++) {
+            uint32_t cell[3];
+            for (int a = 0; a < dims; a++) {
+                cell[a] = static_cast<uint32_t>((points[i][a] - low[a]) * scale);
+            }
+            keys[i] = {hilbertIndex(cell, dims, bits), static_cast<int>(i)};
+        }
+    });
+    parallelSort(keys, less<pair<uint64_t, int>>(), pool);
+
+    // Start first
+    auto first = find_if(keys.begin(), keys.end(), [](const pair<uint64_t, int>& k) { return k.second == 0; });
+    rotate(keys.begin(), first, keys.end());
+    vector<Vertex*> cycle;
+    cycle.reserve(n);
+    for (const auto& k : keys) {
+        cycle.push_back(vertices[k.second]);
+    }
+    Tour tour = verticesToTour(cycle);
+    if (tour.empty()) {
+        return {};
+    }
+    double distance = 0;
+    for (Edge* e : tour) {
         distance += e->getDistance();
     }
 
     // Finish timer
     Time time = stopTimer(start_real,start_cpu,elapsed_real,elapsed_cpu);
-    return {mst,distance,time};
+    return {tour, distance, time};
+}
+
+/**
+ * @brief Heap entry of the insertion heuristics, the cost is copied at push time and the entry is stale once the cost
+ * of the vertex changes
+ */
+struct InsertionEntry {
+    double cost;
+    int vertex;
+
+    bool operator>(const InsertionEntry& other) const {
+        return cost > other.cost || (cost == other.cost && vertex > other.vertex);
+    }
+};
+
+bool Coder::convexHull(const DistanceMatrix& matrix, vector<int>& hull) const {
+    int n = matrix.size();
+    vector<Vertex*> vertices(n);
+    for (int i = 0; i < n; i++) {
+        vertices[i] = matrix.getVertex(i);
+    }
+    vector<Point> points;
+    if (!metricPoints(vertices, points)) {
+        return false;
+    }
+
+    // Points on the sphere are projected on the plane tangent at their mean direction
+    Point normal = {0, 0, 0};
+    bool sphere = false;
+    for (const Point& p : points) {
+        for (int a = 0; a < 3; a++) {
+            normal[a] += p[a];
+        }
+        sphere = sphere || p[2] != 0;
+    }
+    vector<pair<double, double>> plane(n);
+    if (sphere) {
+        double length = sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (length == 0) {
+            return false;
+        }
+        for (double& c : normal) {
+            c /= length;
+        }
+        // Axes of the plane: the coordinate axis least aligned with the normal, made orthogonal, and their cross product
+        int least = 0;
+        for (int a = 1; a < 3; a++) {
+            if (fabs(normal[a]) < fabs(normal[least])) {
+                least = a;
+            }
+        }
+        Point u = {0, 0, 0};
+        u[least] = 1;
+        for (int a = 0; a < 3; a++) {
+            u[a] -= normal[least] * normal[a];
+        }
+        double u_length = sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+        for (double& c : u) {
+            c /= u_length;
+        }
+        Point v = {normal[1] * u[2] - normal[2] * u[1], normal[2] * u[0] - normal[0] * u[2],
+                   normal[0] * u[1] - normal[1] * u[0]};
+        for (int i = 0; i < n; i++) {
+            const Point& p = points[i];
+            plane[i] = {p[0] * u[0] + p[1] * u[1] + p[2] * u[2], p[0] * v[0] + p[1] * v[1] + p[2] * v[2]};
+        }
+    }
+    else {
+        for (int i = 0; i < n; i++) {
+            plane[i] = {points[i][0], points[i][1]};
+        }
+    }
+
+    // Andrew's monotone chain, collinear and repeated points are left out
+    vector<int> order(n);
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&plane](int a, int b) { return plane[a] < plane[b]; });
+    auto turn = [&plane](int o, int a, int b) {
+        return (plane[a].first - plane[o].first) * (plane[b].second - plane[o].second) -
+               (plane[a].second - plane[o].second) * (plane[b].first - plane[o].first);
+    };
+    hull.assign(2 * n, -1);
+    int k = 0;
+    for (int i : order) {
+        while (k >= 2 && turn(hull[k - 2], hull[k - 1], i) <= 0) {
+            k--;
+        }
+        hull[k++] = i;
+    }
+    for (int t = n - 2, lower = k + 1; t >= 0; t--) {
+        int i = order[t];
+        while (k >= lower && turn(hull[k - 2], hull[k - 1], i) <= 0) {
+            k--;
+        }
+        hull[k++] = i;
+    }
+    hull.resize(max(k - 1, 0));
+    return hull.size() >= 3;
+}
+
+Result Coder::insertion(int start_vertex, INSERTION_TYPE type) {
+    // Start timer
+    timespec start_real{};
+    timespec start_cpu{};
+    double elapsed_real, elapsed_cpu;
+    startTimer(start_real, start_cpu);
+
+    Vertex* start = vertices_table->search(start_vertex);
+    if (start == nullptr){
+        throw CustomError("Null Ptr: start vertex is a null ptr",ERROR);
+    }
+    size_t needed = static_cast<size_t>(graph->getNumberOfVertexes()) * graph->getNumberOfVertexes() * sizeof(double);
+    if (needed > memory_limit) {
+        CustomError("Insertion needs " + to_string(needed >> 20) + " MiB for " + to_string(graph->getNumberOfVertexes()) +
+                    " vertices, the limit is " + to_string(memory_limit >> 20) + " MiB", INFO).what();
+        return {};
+    }
+    DistanceMatrix matrix(graph, start);
+    int n = matrix.size();
+    if (n < 2) {
+        return {};
+    }
+    const double INF = DistanceMatrix::INF;
+
+    // Tour as a circular list over the matrix indices (next is -1 out of it), left holds the vertices out of it
+    vector<int> next(n, -1);
+    vector<int> in_tour;
+    vector<int> left;
+    vector<int> left_position(n, -1);
+    auto add = [&](int v) {
+        in_tour.push_back(v);
+        int last = left.back();
+        left[left_position[v]] = last;
+        left_position[last] = left_position[v];
+        left.pop_back();
+    };
+    for (int v = 0; v < n; v++) {
+        left_position[v] = static_cast<int>(left.size());
+        left.push_back(v);
+    }
+
+    // Distance of every tour edge a -> next[a]
+    vector<double> edge(n, INF);
+    auto link = [&](int a, int v) {
+        next[v] = next[a];
+        next[a] = v;
+        edge[v] = matrix.get(v, next[v]);
+        edge[a] = matrix.get(a, v);
+    };
+
+    // Cost of putting v on edge a -> next[a]. When the matrix is symmetric the distances are read along the rows of
+    // a and next[a] (the update after an insertion) or of v (the full search), a row stays in cache while it is used
+    bool symmetric = matrix.isSymmetric();
+    auto insertCost = [&](int a, int v) {
+        double in = matrix.get(a, v);
+        double out = symmetric ? matrix.get(next[a], v) : matrix.get(v, next[a]);
+        return (in == INF || out == INF) ? INF : in + out - edge[a];
+    };
+    auto bestPosition = [&](int v, int& position) {
+        const double* row = matrix.row(v);
+        double best = INF;
+        position = -1;
+        for (int a : in_tour) {
+            double in = symmetric ? row[a] : matrix.get(a, v);
+            double out = row[next[a]];
+            if (in == INF || out == INF) {
+                continue;
+            }
+            double cost = in + out - edge[a];
+            if (cost < best) {
+                best = cost;
+                position = a;
+            }
+        }
+        return best;
+    };
+
+    // First tour: the convex hull, else start and its closest vertex (its farthest for farthest insertion)
+    vector<int> hull;
+    if (type == CONVEX_HULL_INSERTION && !convexHull(matrix, hull)) {
+        CustomError("The convex hull needs coordinates for every vertex, starting from the start vertex", INFO).what();
+        hull.clear();
+    }
+    if (hull.empty()) {
+        int partner = -1;
+        double best = (type == FARTHEST_INSERTION) ? -1 : INF;
+        for (int j = 1; j < n; j++) {
+            double d = matrix.get(0, j) + matrix.get(j, 0);
+            if (d != INF && ((type == FARTHEST_INSERTION) ? d > best : d < best)) {
+                best = d;
+                partner = j;
+            }
+        }
+        if (partner == -1) {
+            return {}; // No solution found
+        }
+        hull = {0, partner};
+    }
+    for (size_t i = 0; i < hull.size(); i++) {
+        next[hull[i]] = hull[(i + 1) % hull.size()];
+        edge[hull[i]] = matrix.get(hull[i], next[hull[i]]);
+        if (edge[hull[i]] == INF) {
+            return {}; // No solution found
+        }
+        add(hull[i]);
+    }
+
+    if (type == NEAREST_INSERTION || type == FARTHEST_INSERTION) {
+        // Distance of every vertex to the tour, updated with the vertex inserted last
+        vector<double> closeness(n, INF);
+        auto approach = [&](int t) {
+            const double* row = matrix.row(t);
+            for (int v : left) {
+                closeness[v] = min({closeness[v], row[v], symmetric ? row[v] : matrix.get(v, t)});
+            }
+        };
+        for (int t : in_tour) {
+            approach(t);
+        }
+        while (!left.empty()) {
+            int chosen = -1;
+            for (int v : left) {
+                if (closeness[v] == INF) {
+                    continue;
+                }
+                if (chosen == -1 || ((type == NEAREST_INSERTION) ? closeness[v] < closeness[chosen]
+                                                                   : closeness[v] > closeness[chosen])) {
+                    chosen = v;
+                }
+            }
+            int position;
+            if (chosen == -1 || bestPosition(chosen, position) == INF) {
+                return {}; // No solution found
+            }
+            link(position, chosen);
+            add(chosen);
+            approach(chosen);
+        }
+    }
+    else {
+        // Best insertion of every vertex, kept up to date after each insertion: only the vertices whose best edge was
+        // split are searched again, the others just try the two new edges
+        vector<double> cost(n, INF);
+        vector<int> position(n, -1);
+        priority_queue<InsertionEntry, vector<InsertionEntry>, greater<>> heap;
+        for (int v : left) {
+            cost[v] = bestPosition(v, position[v]);
+            if (cost[v] != INF) {
+                heap.push({cost[v], v});
+            }
+        }
+        while (!left.empty()) {
+            while (!heap.empty() && (next[heap.top().vertex] != -1 || heap.top().cost != cost[heap.top().vertex])) {
+                heap.pop();
+            }
+            if (heap.empty()) {
+                return {}; // No solution found
+            }
+            int chosen = heap.top().vertex;
+            heap.pop();
+            int a = position[chosen];
+            link(a, chosen);
+            add(chosen);
+
+            for (int v : left) {
+                double previous = cost[v];
+                if (position[v] == a) {
+                    cost[v] = bestPosition(v, position[v]);
+                }
+                else {
+                    for (int edge : {a, chosen}) {
+                        double c = insertCost(edge, v);
+                        if (c < cost[v]) {
+                            cost[v] = c;
+                            position[v] = edge;
+                        }
+                    }
+                }
+                if (cost[v] != previous && cost[v] != INF) {
+                    heap.push({cost[v], v});
+                }
+            }
+        }
+    }
+
+    // Start first
+    vector<int> order = {0};
+    for (int v = next[0]; v != 0; v = next[v]) {
+        order.push_back(v);
+    }
+    Tour tour = orderToTour(matrix, order);
+    if (tour.empty()) {
+        return {};
+    }
+    double distance = 0;
+    for (Edge* e : tour) {
+        distance += e->getDistance();
+    }
+
+    // Finish timer
+    Time time = stopTimer(start_real,start_cpu,elapsed_real,elapsed_cpu);
+    return {tour, distance, time};
+}
+
+Result Coder::multiStart(CONSTRUCTION_TYPE construction, int starts, int threads) {
+    // Start timer
+    timespec start_real{};
+    timespec start_cpu{};
+    double elapsed_real, elapsed_cpu;
+    startTimer(start_real, start_cpu);
+
+    vector<Vertex*> vertices = graph->getVertexSet();
+    int n = static_cast<int>(vertices.size());
+    if (n < 2) {
+        return {};
+    }
+
+    // The MST does not depend on the root: computed once (prim may add measured edges, before the copy is made)
+    vector<int> parent(n, -1);
+    if (construction == TRIANGULAR_CONSTRUCTION) {
+        if (static_cast<int>(prim(vertices[0]).size()) != n) {
+            return {};
+        }
+        unordered_map<const Vertex*, int> index;
+        for (int i = 0; i < n; i++) {
+            index[vertices[i]] = i;
+        }
+        for (int i = 1; i < n; i++) {
+            Edge* e = vertices[i]->getPath();
+            if (e == nullptr) {
+                return {};
+            }
+            parent[i] = index.at(e->getOrigin());
+        }
+    }
+    MultiStart runs(vertices, graph->getMetric());
+    if (construction == TRIANGULAR_CONSTRUCTION) {
+        runs.setTree(parent);
+    }
+
+    // Start vertices, a fixed sample when not all of them are used
+    vector<int> list(n);
+    iota(list.begin(), list.end(), 0);
+    if (starts > 0 && starts < n) {
+        mt19937 random(12345);
+        shuffle(list.begin(), list.end(), random);
+        list.resize(starts);
+        sort(list.begin(), list.end());
+    }
+
+    // Every thread keeps its best run, ties go to the first start of the list
+    ThreadPool pool(threads);
+    int workers = pool.getThreads();
+    vector<MultiStart::Scratch> scratch;
+    for (int t = 0; t < workers; t++) {
+        scratch.push_back(runs.makeScratch());
+    }
+    vector<double> costs(list.size(), numeric_limits<double>::infinity());
+    vector<pair<double, size_t>> best(workers, {numeric_limits<double>::infinity(), list.size()});
+    vector<vector<int>> best_order(workers);
+    pool.parallelFor(0, list.size(), 1, [&](size_t begin, size_t end, int thread) {
+        vector<int> order;
+        for (size_t s = begin; s < end; s++) {
+            costs[s] = (construction == TRIANGULAR_CONSTRUCTION)
+                       ? runs.treeWalk(list[s], scratch[thread], order)
+                       : runs.nearestNeighbor(list[s], construction == NEAREST_NEIGHBOR_CONSTRUCTION, scratch[thread], order);
+            if (make_pair(costs[s], s) < best[thread]) {
+                best[thread] = {costs[s], s};
+                best_order[thread] = order;
+            }
+        }
+    });
+    int winner = static_cast<int>(min_element(best.begin(), best.end()) - best.begin());
+    if (best[winner].first == numeric_limits<double>::infinity()) {
+        return {}; // No solution found
+    }
+
+    // Edges of the best tour, the only change to the graph
+    vector<Vertex*> cycle;
+    cycle.reserve(n);
+    for (int v : best_order[winner]) {
+        cycle.push_back(vertices[v]);
+    }
+    Tour tour = verticesToTour(cycle);
+    if (tour.empty()) {
+        return {};
+    }
+    double distance = 0;
+    for (Edge* e : tour) {
+        distance += e->getDistance();
+    }
+
+    // Finish timer
+    Time time = stopTimer(start_real,start_cpu,elapsed_real,elapsed_cpu);
+    Result result = {tour, distance, time};
+    for (size_t s = 0; s < list.size(); s++) {
+        result.start_costs.emplace_back(vertices[list[s]]->getId(), costs[s]);
+    }
+    return result;
 }
 
 Result Coder::realWorld(int start_vertex) {
@@ -582,61 +2175,93 @@ Result Coder::nearestNeighbor(int start_vertex) {
     vector <Vertex*> vertices;
 
     Vertex* start = vertices_table->search(start_vertex);
-    Vertex* current = start;
+    if (start == nullptr) {
+        throw CustomError("NullPtr: vertex start is a null ptr", ERROR);
+    }
+    graph->resetVisited();
 
-    current->setVisited(true);
-    vertices.push_back(current);
+    // Vertices not visited yet in a k-d tree when the metric gives them points: a vertex with no edge left is then
+    // followed by a query of the tree instead of a scan of every vertex
+    vector<Vertex*> all = startFirst(start);
+    vector<Point> points;
+    unique_ptr<KdTree> tree;
+    unordered_map<const Vertex*, int> index;
+    if (metricPoints(all, points)) {
+        tree = make_unique<KdTree>(std::move(points));
+        for (int i = 0; i < static_cast<int>(all.size()); i++) {
+            index[all[i]] = i;
+        }
+    }
+    auto visit = [&](Vertex* v) {
+        v->setVisited(true);
+        vertices.push_back(v);
+        if (tree != nullptr) {
+            tree->remove(index.at(v));
+        }
+    };
+
+    Vertex* current = start;
+    visit(current);
     Edge* min;
 
-    do {
+    while (vertices.size() != all.size()) {
         min = nullptr;
         for (auto b : current->getAdj()){
             if (b->getDestination()->isVisited()){
                 continue;
             }
-            if (min == nullptr){
-                min = b;
-            }
-            else if (min > b){
+            if (min == nullptr || b->getDistance() < min->getDistance()){
                 min = b;
             }
         }
 
         if(min != nullptr) {
             res.push_back(min);
-            vertices.push_back(min->getDestination());
-            min->getDestination()->setVisited(true);
             current = min->getDestination();
+            visit(current);
         }
         else{
-            double min_distance = INT32_MAX;
+            double min_distance = numeric_limits<double>::max();
             Vertex* dest = nullptr;
-            for (auto a : graph->getVertexSet()){
-                if (!a->isVisited()){
-                    if (a->getCoordinates() == nullptr || current->getCoordinates() == nullptr){
-                        continue;
-                    }
-                    else{
-                        double distance = haversineDistance(current,a);
-                        if (distance < min_distance ){
-                            min_distance = distance;
-                            dest = a;
+            if (tree != nullptr) {
+                int nearest = tree->nearestLeft(index.at(current));
+                if (nearest != -1) {
+                    dest = all[nearest];
+                    min_distance = measureDistance(current, dest);
+                }
+            }
+            else {
+                for (auto a : graph->getVertexSet()){
+                    if (!a->isVisited()){
+                        if (!canMeasure(a, current)){
+                            continue;
+                        }
+                        else{
+                            double distance = measureDistance(current,a);
+                            if (distance < min_distance ){
+                                min_distance = distance;
+                                dest = a;
+                            }
                         }
                     }
                 }
             }
             if (dest == nullptr){
+                graph->resetVisited();
                 return {}; // No solution found
             }
             else{
-                graph->addEdge(current,dest,min_distance);
-                vertices.push_back(dest);
-                dest->setVisited(true);
+                res.push_back(graph->addEdge(current,dest,min_distance));
                 current = dest;
+                visit(current);
             }
         }
 
-    } while(vertices.size() != graph->getVertexSet().size());
+    }
+    if (res.empty()) {
+        graph->resetVisited();
+        return {};
+    }
 
     bool findCycle = false;
     for (auto a: res.back()->getDestination()->getAdj()){
@@ -648,10 +2273,11 @@ Result Coder::nearestNeighbor(int start_vertex) {
     }
 
     if (!findCycle) {
-        if (res.back()->getDestination()->getCoordinates() == nullptr || start->getCoordinates() == nullptr) {
+        if (!canMeasure(res.back()->getDestination(), start)) {
+            graph->resetVisited();
             return {}; // No solution found
         } else {
-            double distance = haversineDistance(res.back()->getDestination(), start);
+            double distance = measureDistance(res.back()->getDestination(), start);
             Edge *cycle = graph->addEdge(res.back()->getDestination(), start, distance);
             res.push_back(cycle);
         }
@@ -3,9 +3,34 @@
 
 /**< Project header >**/
 #include "HashTable.h"
+#include "BranchBound.h"
+#include "Matching.h"
+#include "SpanningTree.h"
+#include "KdTree.h"
+#include "MultiStart.h"
 #include "../model/Graph.h"
+#include "../model/DistanceMatrix.h"
 #include "../Exceptions/CustomError.h"
 
+/**
+ * @brief Rule of the insertion heuristics, which vertex goes into the tour next
+ */
+enum INSERTION_TYPE{
+    NEAREST_INSERTION,    /**< The vertex closest to the tour >**/
+    FARTHEST_INSERTION,   /**< The vertex farthest from the tour >**/
+    CHEAPEST_INSERTION,   /**< The vertex whose best position increases the tour the least >**/
+    CONVEX_HULL_INSERTION /**< Cheapest insertion starting from the convex hull of the points >**/
+};
+
+/**
+ * @brief Constructions run from many start vertices by the multi-start mode
+ */
+enum CONSTRUCTION_TYPE{
+    NEAREST_NEIGHBOR_CONSTRUCTION, /**< Nearest neighbor >**/
+    REAL_WORLD_CONSTRUCTION,       /**< Real world (edges of the graph only) >**/
+    TRIANGULAR_CONSTRUCTION        /**< Triangular approximation (pre-order walk of the MST) >**/
+};
+
 /**
  * @struct Time
  * @param elapsed_real
@@ -21,12 +46,22 @@ struct Time {
  * @param path
  * @param distance
  * @param time_spent
+ * @param nodes - search nodes expanded (exact searches only)
+ * @param thread_nodes - nodes expanded by each thread (parallel searches only)
+ * @param stopped - the exact search stopped at the time limit, the tour is the best found and not a proven optimum
+ * @param lower_bound - best known lower bound of the optimum (exact searches only)
+ * @param start_costs - start vertex id and tour cost of every start tried, infinity if it gave no tour (multi-start only)
  */
  typedef vector<Edge*> Tour;
 struct Result {
     Tour tour;
     double distance;
     Time time_spent;
+    unsigned long long nodes = 0;
+    vector<unsigned long long> thread_nodes{};
+    bool stopped = false;
+    double lower_bound = 0;
+    vector<pair<int, double>> start_costs{};
 };
 
 /**
@@ -47,17 +82,158 @@ public:
 
     /**
      * @brief Backtracking algorithm (more used for small graphs)
-     * @Complexity - O(b^d), where b is the branching factor and d is the depth of the recursion tree
-     * @return Result
+     *
+     * Enumerates the tours over the distance matrix with an explicit stack and a 64-bit visited mask, the graph is not
+     * touched during the search. Symmetric tours are enumerated in one direction and partial paths that a 2-opt /
+     * Or-opt move improves are skipped. Sizes over 64 vertices are refused (empty result). Stops with the best tour found
+     * when the time limit is reached.
+     *
+     * @Complexity - O(V!) time, O(V) memory
+     * @param start_vertex - The vertex from which to start building the Hamiltonian cycle.
+     * @return Result (nodes holds the nodes visited)
      */
     Result backtracking(int start_vertex = 0);
 
     /**
      * @brief Branch and Bound algorithm (more efficient than backtracking)
-     * @Complexity -O(V)
-     * @return Result
+     *
+     * Depth first over the distance matrix: the incumbent starts as a nearest neighbour + 2-opt tour, children are
+     * expanded nearest first and a path is pruned when its cost plus the lower bound of the rest is not better than
+     * the incumbent (see BranchBound).
+     *
+     * @Complexity - O(V! * V^2) in the worst case, far less nodes in practice
+     * @param start_vertex - The vertex from which to start building the Hamiltonian cycle.
+     * @param bound - lower bound used to prune
+     * @return Result (nodes holds the nodes expanded)
+     */
+    Result branchBound(int start_vertex = 0, BOUND_TYPE bound = ONE_TREE);
+
+    /**
+     * @brief Parallel Branch and Bound, subtrees are spread over per-thread work-stealing deques.
+     *
+     * Same bounds as branchBound, the incumbent is shared by all threads. Ties with the incumbent are not pruned and
+     * the smallest vertex order wins, so the optimum and the tour are the same for any number of threads.
+     *
+     * @Complexity - O(V! * V^2 / threads) in the worst case
+     * @param start_vertex - The vertex from which to start building the Hamiltonian cycle.
+     * @param bound - lower bound used to prune
+     * @param threads - number of threads, 0 uses the hardware concurrency
+     * @return Result (nodes and thread_nodes hold the nodes expanded)
+     */
+    Result parallelBranchBound(int start_vertex = 0, BOUND_TYPE bound = ONE_TREE, int threads = 0);
+
+    /**
+     * @brief Best first Branch and Bound, the open node with the lowest bound is expanded first.
+     *
+     * Open nodes are compact records (bitmask, last vertex, cost, bound) limited by the memory limit, once it is
+     * reached the open nodes are finished depth first. The progress callback sees the incumbent and the best known
+     * bound while it runs. Instances over 64 vertices are searched depth first.
+     *
+     * @Complexity - O(V! * V^2) in the worst case, O(memory limit) memory
+     * @param start_vertex - The vertex from which to start building the Hamiltonian cycle.
+     * @param bound - lower bound used to prune
+     * @return Result (nodes holds the nodes expanded)
+     */
+    Result bestFirstBranchBound(int start_vertex = 0, BOUND_TYPE bound = ONE_TREE);
+
+    /**
+     * @brief Set the callback that receives the progress of the exact searches
+     * @param callback - nullptr disables it
+     */
+    void setProgress(ProgressCallback callback);
+
+    /**
+     * @brief Set the time limit of the exact searches (backtracking and Branch and Bound), they return the best tour
+     * found when it is reached
+     * @param seconds - 0 for none
+     */
+    void setTimeLimit(double seconds);
+
+    /**
+     * @brief Time limit of the exact searches
+     * @return seconds, 0 for none
+     */
+    [[nodiscard]] double getTimeLimit() const;
+
+    /**
+     * @brief Set the checkpoint file of the Branch and Bound searches. A search stopped by the time limit saves its
+     * frontier there and the next search of the same graph resumes from it, the file is removed once a search ends.
+     * @param path - empty disables checkpoints
+     */
+    void setCheckpoint(const string& path);
+
+    /**
+     * @brief Checkpoint file of the Branch and Bound searches
+     * @return path, empty for none
+     */
+    [[nodiscard]] const string& getCheckpoint() const;
+
+    /**
+     * @brief Held-Karp dynamic programming exact algorithm.
+     *
+     * The cost of the best path from the start through a subset S (bitmask) ending at j is built from the subsets
+     * S - {j}, so every subset is solved once. The cost table uses 32-bit integers when all distances are integers
+     * (exact), doubles otherwise (floats only if doubles don't fit), plus one byte per entry for the parent used to
+     * rebuild the tour. Sizes whose table does not fit the memory limit are refused (empty result).
+     *
+     * @Complexity - O(V^2 * 2^V) time, O(V * 2^V) memory
+     *
+     * @param start_vertex - The vertex from which to start building the Hamiltonian cycle.
+     * @return A ResultCoder object containing the optimal Hamiltonian cycle, its total distance, and the time taken for computation.
+     */
+    Result heldKarp(int start_vertex = 0);
+
+    /**
+     * @brief Parallel Held-Karp, every layer of subsets (same number of vertices) is solved across a thread pool.
+     *
+     * Gives the same optimum and tour as heldKarp, with the same memory limit.
+     *
+     * @Complexity - O(V^2 * 2^V / threads) time, O(V * 2^V) memory
+     *
+     * @param start_vertex - The vertex from which to start building the Hamiltonian cycle.
+     * @param threads - number of threads, 0 uses the hardware concurrency
+     * @return A ResultCoder object containing the optimal Hamiltonian cycle, its total distance, and the time taken for computation.
+     */
+    Result parallelHeldKarp(int start_vertex = 0, int threads = 0);
+
+    /**
+     * @brief Exact solver picked by size: the size specialized solvers up to TinySolver::MAX_SIZE vertices, then
+     * parallel Held-Karp while its table fits the memory limit, else parallel Branch and Bound (assignment bound for
+     * directed graphs, 1-tree otherwise).
+     *
+     * @Complexity - O(V^2 * 2^V) up to the Held-Karp limit, O(V! * V^2) in the worst case after
+     *
+     * @param start_vertex - The vertex from which to start building the Hamiltonian cycle.
+     * @return A ResultCoder object containing the optimal Hamiltonian cycle, its total distance, and the time taken for computation.
+     */
+    Result exactSolve(int start_vertex = 0);
+
+    /**
+     * @brief Memory needed by the Held-Karp tables
+     * @param n - number of vertices
+     * @param cost_size - bytes per cost entry (4 for int/float, 8 for double)
+     * @return bytes (saturates at SIZE_MAX)
      */
-    Result branchBound(int start_vertex = 0);
+    static size_t heldKarpMemory(int n, size_t cost_size = sizeof(float));
+
+    /**
+     * @brief Memory needed by the Held-Karp tables on the current graph, with the cost type heldKarp will pick
+     * @Complexity - O(V^2 + E) when Held-Karp can run on the graph, O(1) otherwise
+     * @return bytes (saturates at SIZE_MAX)
+     */
+    [[nodiscard]] size_t graphHeldKarpMemory() const;
+
+    /**
+     * @brief Memory limit for the tables of the exact algorithms
+     * @return bytes
+     */
+    [[nodiscard]] size_t getMemoryLimit() const;
+
+    /**
+     * @brief Set a new memory limit for the tables of the exact algorithms
+     * @param bytes
+     */
+    void setMemoryLimit(size_t bytes);
 
     /**
      * @brief Approximates the shortest Hamiltonian cycle using triangular approximation algorithm.
@@ -73,12 +249,80 @@ public:
      */
     Result triangularApproximation(int start_vertex = 0);
 
+    /**
+     * @brief Christofides 1.5-approximation (for metric distances).
+     *
+     * The minimum spanning tree of prim plus a perfect matching of its odd degree vertices is a graph where every
+     * vertex has even degree, so it has an Euler tour, which is shortcut into a Hamiltonian cycle (each vertex kept at
+     * its first visit). Pairs are matched by their edge if the graph has one, else by the graph metric. The optimal
+     * matching falls back to the greedy one when its tables don't fit the memory limit or there are more than
+     * Matching::OPTIMAL_MAX_SIZE odd degree vertices.
+     *
+     * @Complexity - O(V^2) plus O(k^3) for the optimal matching or O(k^2) for the greedy one (k odd degree vertices)
+     *
+     * @param start_vertex - The vertex from which to start building the Hamiltonian cycle.
+     * @param matching - optimal (blossom) or greedy matching of the odd degree vertices
+     * @return A ResultCoder object containing the Hamiltonian cycle, its total distance, and the time taken for computation.
+     */
+    Result christofides(int start_vertex = 0, MATCHING_TYPE matching = OPTIMAL_MATCHING);
+
+    /**
+     * @brief Greedy edge (multi-fragment) construction.
+     *
+     * Candidate edges are the edges of the graph plus, when the metric gives every vertex a point, the nearest
+     * neighbours of the vertices with few edges. They are sorted once (in parallel) and taken cheapest first when both
+     * ends have degree below 2 and a union-find says they are in different fragments. The fragments left are chained
+     * nearest endpoint first, starting from the one of start_vertex.
+     *
+     * @Complexity - O(E log E) for the candidates plus O(F^2) to chain F fragments
+     *
+     * @param start_vertex - The vertex from which to start building the Hamiltonian cycle.
+     * @return A ResultCoder object containing the Hamiltonian cycle, its total distance, and the time taken for computation.
+     */
+    Result greedyEdge(int start_vertex = 0);
+
+
+    /**
+     * @brief Space filling curve tour: every vertex is mapped to its position on a Hilbert curve over the bounding box
+     * of its coordinates (2D for planar instances, 3D on the unit sphere for geographic ones) and visited in that order.
+     * Nearby points are close on the curve, the tour is about 40% longer than optimal on uniform points, good enough
+     * as a warm start or for instances too large for the other heuristics. Only the coordinates are used to order
+     * the vertices, the edge distances of the graph are ignored.
+     *
+     * @Complexity - O(n log n)
+     *
+     * @param start_vertex - The vertex from which to start building the Hamiltonian cycle.
+     * @return A ResultCoder object containing the Hamiltonian cycle, its total distance, and the time taken for computation.
+     * Empty if a vertex has no coordinates.
+     */
+    Result hilbertCurve(int start_vertex = 0);
+
+
+    /**
+     * @brief Insertion heuristics: starting from a small tour (start and its closest vertex, its farthest for farthest
+     * insertion, or the convex hull of the points), the vertex chosen by the rule is put at its cheapest position
+     * until every vertex is in.
+     *
+     * Nearest and farthest keep the distance of every vertex to the tour, updated in O(n) after each insertion.
+     * Cheapest and convex hull keep the best position of every vertex and a heap keyed by its cost: after an insertion
+     * only the vertices whose best edge was split are searched again, the others only try the two new edges.
+     *
+     * @Complexity - O(n^2) for nearest and farthest, O(n^2 log n) expected for cheapest and convex hull, O(n^2) memory
+     *
+     * @param start_vertex - The vertex from which to start building the Hamiltonian cycle.
+     * @param type - insertion rule
+     * @return A ResultCoder object containing the Hamiltonian cycle, its total distance, and the time taken for computation.
+     */
+    Result insertion(int start_vertex = 0, INSERTION_TYPE type = CHEAPEST_INSERTION);
+
 
     /**
      * @brief This algorithm chooses the always the nearest vertex in the graph, so is greedy.
      * It's results are normally in the range of 1.5 to 2 times worst than the optimal solution given for example with backtracking.
+     * The cheapest edge to a vertex not visited is followed, when there is none the closest vertex by the metric is
+     * taken from a k-d tree of the vertices not visited (a scan of every vertex if the graph has no coordinates).
      *
-     * @Complexity - O(n^2)
+     * @Complexity - O(E + n log n) with coordinates, O(n^2) without
      *
      * @param start_vertex - The vertex from which to start building the Hamiltonian cycle.
      * @return A ResultCoder object containing the Hamiltonian cycle, its total distance, and the time taken for computation.
@@ -86,6 +330,23 @@ public:
     Result nearestNeighbor(int start_vertex = 0);
 
 
+    /**
+     * @brief Runs a construction from every vertex (or from a sample of them) on a thread pool and keeps the best tour.
+     *
+     * The runs read a copy of the graph made before they start and keep their visited flags apart, the graph is only
+     * changed at the end to build the edges of the best tour. The triangular approximation computes the MST once and
+     * only walks it from every root.
+     *
+     * @Complexity - O(starts * run / threads)
+     *
+     * @param construction - construction to run
+     * @param starts - number of start vertices, sampled with a fixed seed (0 -> every vertex)
+     * @param threads - number of threads, 0 uses the hardware concurrency
+     * @return Result with the best tour, start_costs holds the cost from every start tried
+     */
+    Result multiStart(CONSTRUCTION_TYPE construction, int starts = 0, int threads = 0);
+
+
     /**
      * @brief -> The real world algorithm is very similar to nearest neighbor, but if a real path is not found, the
      * result is gives no solution found, instead of trying to find new fake paths.
@@ -142,88 +403,213 @@ private:
     bool isGraphComplete();
 
 
+
+
     /**
-     * @brief Visits vertices in pre-order traversal starting from the given vertex.
-     *
-     * This function performs a pre-order traversal starting from the given vertex.
-     * It visits each vertex and its adjacent vertices in pre-order, adding them to the provided vector.
+     * @brief Checks if the graph metric can measure the distance between two vertices without an edge.
      *
-     * @Complexity - O(V)
+     * @Complexity - O(1)
      *
-     * @param current The current vertex being visited.
-     * @param t Reference to a vector to store the vertices visited in pre-order.
+     * @param origin Pointer to the origin vertex.
+     * @param destination Pointer to the destination vertex.
+     * @return True if the distance can be measured (coordinates or explicit matrix), otherwise false.
      */
-    void preOrderVisit(Vertex* current, vector<Vertex*>& t);
-
-
-
+    bool canMeasure(Vertex* origin, Vertex* destination) const;
 
     /**
-     * @brief Calculates the Haversine distance between two vertices on the Earth's surface.
+     * @brief Calculates the distance between two vertices using the graph metric.
      *
-     * This function calculates the Haversine distance, which is the shortest distance over the earth's surface
-     * given the longitude and latitude coordinates of two points.
+     * For the project datasets this is the Haversine distance (shortest distance over the earth's surface in meters),
+     * for TSPLIB instances it is the EDGE_WEIGHT_TYPE of the file.
      *
      * @Complexity - O(1)
      *
      * @param origin Pointer to the origin vertex.
      * @param destination Pointer to the destination vertex.
-     * @return The Haversine distance between the origin and destination vertices in meters.
+     * @return The distance between the origin and destination vertices.
      */
-    static double haversineDistance(Vertex* origin, Vertex* destination);
+    double measureDistance(Vertex* origin, Vertex* destination) const;
 
 
     /**
      * @brief Implements Prim's algorithm to find the Minimum Spanning Tree (MST) starting from a specified vertex.
      *
      * This function implements Prim's algorithm to find the Minimum Spanning Tree (MST) of the graph,
-     * starting from the specified start vertex. It returns the MST as a tour.
+     * starting from the specified start vertex. It returns the pre-order walk of the MST.
+     *
+     * Large coordinate-only graphs are solved by candidateSpanningTree, dense graphs (see useDensePrim) by densePrim,
+     * large undirected ones by parallelSpanningTree and the others with a binary heap.
      *
-     * @Complexity - O(V log V + E)
+     * @Complexity - O(V log V + E), O(V^2) for dense graphs
      *
      * @param start Pointer to the start vertex from which the algorithm begins.
-     * @return The Minimum Spanning Tree (MST) represented as a tour.
+     * @note Leaves the key and path of every vertex, the visited flags are cleared
+     * @return The vertices of the MST in pre-order, start first (only the vertices reached from start).
+     */
+    vector<Vertex*> prim(Vertex* start);
+
+    /**
+     * @brief Prim with contiguous key / parent arrays and no heap: every step takes the closest vertex with a SIMD
+     * min-reduction over the keys and relaxes the keys through its edges (or the graph metric if it has none).
+     * Leaves the same vertex state as the heap version (key, path of every reached vertex), only the tree edges
+     * measured by the metric are added to the graph (in both directions).
+     * @Complexity - O(V^2 + E)
+     * @param start - start vertex
+     */
+    void densePrim(Vertex* start);
+
+    /**
+     * @brief The heap does E log V work against the V^2 of the dense version, a vertex without edges counts as
+     * connected to every other one (its edges come from the metric)
+     * @return true if E * log2(V) >= V^2
+     */
+    bool useDensePrim() const;
+
+    /**
+     * @brief Pre-order walk of the tree left by prim (the path of every reached vertex is the edge from its parent):
+     * the children of every vertex go to contiguous arrays and an explicit stack walks them, so deep trees can't
+     * overflow the call stack and no adjacency is scanned. Clears the visited flags set by prim.
+     * @Complexity - O(V)
+     * @param start - root of the tree
+     * @return vertices in pre-order, start first
+     */
+    vector<Vertex*> mstPreOrder(Vertex* start);
+
+    /**
+     * @brief MST of large undirected graphs with the parallel Borůvka of SpanningTree, leaves the same vertex state as
+     * prim (key, path of every vertex reached from start)
+     * @note Ties are broken by edge order, with distinct distances the tree is the one of prim
+     * @Complexity - O(E log V / threads)
+     * @param start - root of the tree
+     * @return false (and nothing changed) for a small graph, a single core, a vertex without edges or an edge without
+     * its opposite
+     */
+    bool parallelSpanningTree(Vertex* start);
+
+    /**
+     * @brief MST of large coordinate-only graphs: the nearest neighbours of every vertex (k-d tree over the points of
+     * the metric) make a sparse candidate graph that holds the tree in practice, and Borůvka finds the MST over it.
+     * Pieces of a disconnected candidate graph are joined by their closest pairs. Leaves the same vertex state as prim,
+     * the tree edges are added to the graph in both directions.
+     * @Complexity - O(V log V) expected
+     * @param start - root of the tree
+     * @return false (and nothing changed) for a small graph or a vertex with edges or without a point
+     */
+    bool candidateSpanningTree(Vertex* start);
+
+    /**
+     * @brief Vertices of the graph, start first and then the vertex set order
+     * @param start - first vertex
+     * @return vertices
+     */
+    vector<Vertex*> startFirst(Vertex* start) const;
+
+    /**
+     * @brief Point of every vertex in the metric (see Metric::getPoint)
+     * @param vertices - vertices
+     * @param points - output, one per vertex
+     * @return false if a vertex has no point
+     */
+    bool metricPoints(const vector<Vertex*>& vertices, vector<Point>& points) const;
+
+    /**
+     * @brief Edges from the selected vertices to their CANDIDATE_NEIGHBOURS nearest points (in parallel), measured by
+     * the graph edge between them if there is one and by the metric otherwise
+     * @param vertices - vertices by index
+     * @param tree - k-d tree over the metric points of the same vertices
+     * @param selected - vertices whose neighbours are taken
+     * @return edges, u < v
+     */
+    vector<TreeEdge> nearestEdges(const vector<Vertex*>& vertices, const KdTree& tree, const vector<char>& selected);
+
+    /**
+     * @brief Convex hull of the metric points (projected on their tangent plane when on the sphere)
+     * @Complexity - O(n log n)
+     * @param matrix - the hull holds indices of this matrix
+     * @param hull - output, hull vertices in order
+     * @return false if a vertex has no coordinates or the points are collinear
+     */
+    bool convexHull(const DistanceMatrix& matrix, vector<int>& hull) const;
+
+    /**
+     * @brief Roots a spanning forest at vertices[0] and leaves the vertex state of prim: the path of a vertex is the edge
+     * from its parent and the key its distance, the vertices out of the tree keep the maximum key
+     * @param vertices - vertices by index, the root first
+     * @param edges - undirected edges over the indices
+     * @param forest - positions in edges of the forest edges
+     * @param edge - graph edge x -> y of forest edge p, called as edge(p, x, y)
+     */
+    void rootTree(const vector<Vertex*>& vertices, const vector<TreeEdge>& edges, const vector<int>& forest,
+                  const function<Edge*(int, int, int)>& edge);
+
+    /**
+     * @brief Branch and Bound shared by the sequential and parallel versions
+     * @param start_vertex - The vertex from which to start building the Hamiltonian cycle.
+     * @param bound - lower bound used to prune
+     * @param threads - number of threads (0 -> sequential depth first search)
+     * @param best_first - sequential best first search
+     * @return Result
+     */
+    Result branchBoundSolve(int start_vertex, BOUND_TYPE bound, int threads, bool best_first = false);
+
+    /**
+     * @brief Held-Karp shared by the sequential and parallel versions
+     * @param start_vertex - The vertex from which to start building the Hamiltonian cycle.
+     * @param threads - number of threads (1 -> sequential)
+     * @return Result
+     */
+    Result heldKarpSolve(int start_vertex, int threads);
+
+    /**
+     * @brief Bytes per Held-Karp cost: int32 if the distances are integers and no tour can overflow it, else double,
+     * or float when the double tables don't fit the memory limit
+     * @param matrix - distances
+     * @return cost size
      */
-    Tour prim(Vertex* start);
+    [[nodiscard]] size_t heldKarpCostSize(const DistanceMatrix& matrix) const;
 
     /**
-     * @brief Recursive helper function for the backtracking algorithm to find the shortest tour.
+     * @brief Converts a vertex order of a distance matrix into a closed tour.
      *
-     * This function is a recursive helper for the backtracking algorithm to find the shortest tour
-     * starting from a specified vertex. It explores all possible paths and backtracks when necessary.
+     * Edges of the graph are used when they exist, else they are added with the graph metric distance (same as the
+     * other algorithms do when an edge is missing).
      *
-     * @complexity - O(V!) in the worst case
+     * @Complexity - O(V * deg)
      *
-     * @param start The starting vertex of the tour.
-     * @param min_distance Reference to the minimum distance found so far.
-     * @param current_vertex The current vertex being visited.
-     * @param current_distance The current distance of the tour.
-     * @param path The current path being explored.
-     * @param min_path Reference to the path representing the shortest tour found so far.
-     * @param is_complete Flag indicating whether the graph is complete.
+     * @param matrix - matrix used to compute the order
+     * @param order - matrix indices in visiting order (starting at 0)
+     * @return tour, empty if an edge can't be built
      */
-    void backtrackingHelper(Vertex* start, double& min_distance, Vertex* current_vertex, double current_distance, Tour& path, Tour& min_path, bool is_complete);
+    Tour orderToTour(const DistanceMatrix& matrix, const vector<int>& order);
 
     /**
-     * @brief Recursive helper function for the Branch and Bound algorithm to find the shortest tour.
+     * @brief Converts a vertex order into a closed tour, missing edges are added with the graph metric distance.
+     * Large tours are built in parallel.
      *
-     * This function is a recursive helper for the Branch and Bound algorithm to find the shortest tour
-     * starting from a specified vertex. It explores all possible paths using backtracking and prunes branches
-     * based on a lower bound on the tour length.
+     * @Complexity - O(V * deg)
      *
-     * @complexity - O(V!) in the worst case
-     *
-     * @param start The starting vertex of the tour.
-     * @param min_distance Reference to the minimum distance found so far.
-     * @param current_vertex The current vertex being visited in the tour.
-     * @param current_distance The current distance of the tour.
-     * @param path The current path being explored.
-     * @param min_path Reference to the path representing the shortest tour found so far.
+     * @param order - vertices in visiting order, each one once
+     * @return tour, empty if an edge can't be built
      */
-    void branchBoundHelper(Vertex* start, double& min_distance, Vertex* current_vertex, double current_distance, Tour& path, Tour& min_path);
+    Tour verticesToTour(const vector<Vertex*>& order);
+
+    /**
+     * @brief Default memory limit (3/4 of the physical memory)
+     * @return bytes
+     */
+    static size_t getDefaultMemoryLimit();
+
+    static constexpr size_t PARALLEL_MST_EDGES = 1 << 16; /**< Edges from which prim runs Borůvka in parallel >**/
+    static constexpr int CANDIDATE_MST_VERTICES = 1 << 11; /**< Vertices from which coordinate-only MSTs use candidates >**/
+    static constexpr int CANDIDATE_NEIGHBOURS = 10; /**< Nearest neighbours of each vertex in the candidate graph >**/
+    static constexpr size_t PARALLEL_TOUR_VERTICES = 1 << 16; /**< Vertices from which tours are built in parallel >**/
 
     Graph* graph; /**< Graph >**/
     HashTable* vertices_table; /**< Vertices table >**/
+    size_t memory_limit = getDefaultMemoryLimit(); /**< Memory limit for the exact algorithms tables >**/
+    ProgressCallback progress; /**< Progress of the exact searches, may be empty >**/
+    double time_limit = 0; /**< Seconds allowed to the exact searches, 0 for none >**/
+    string checkpoint_path; /**< Checkpoint of the Branch and Bound searches, empty for none >**/
 };
 
 
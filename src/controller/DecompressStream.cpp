@@ -0,0 +1,235 @@
+/**
+ * @file DecompressStream.cpp
+ * @brief Implementation of the streaming decompression used by the parser
+ */
+
+/**< Project headers >**/
+#include "DecompressStream.h"
+#include "../Exceptions/CustomError.h"
+/**< STD headers >**/
+#include <filesystem>
+/**< Compression libraries (optional, see CMakeLists.txt) >**/
+#ifdef TSP_ANALYSIS_ZLIB
+#include <zlib.h>
+#endif
+#ifdef TSP_ANALYSIS_ZSTD
+#include <zstd.h>
+#endif
+
+DecompressBuffer::DecompressBuffer(const string& file_path, COMPRESSION _type) : type(_type) {
+    file.open(file_path, ios::in | ios::binary);
+    if (!file.is_open()) {
+        throw CustomError("Error opening file", FILE_ERROR);
+    }
+    setg(nullptr, nullptr, nullptr);
+    worker = thread(&DecompressBuffer::produce, this);
+}
+
+DecompressBuffer::~DecompressBuffer() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopped = true;
+    }
+    changed.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+DecompressBuffer::int_type DecompressBuffer::underflow() {
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+    unique_lock<mutex> guard(lock);
+    changed.wait(guard, [this] { return !chunks.empty() || finished; });
+    if (chunks.empty()) {
+        if (!error.empty()) {
+            throw CustomError(error, FILE_ERROR);
+        }
+        return traits_type::eof();
+    }
+    current = std::move(chunks.front());
+    chunks.pop_front();
+    guard.unlock();
+    changed.notify_all();
+
+    setg(current.data(), current.data(), current.data() + current.size());
+    return traits_type::to_int_type(*gptr());
+}
+
+bool DecompressBuffer::push(vector<char>&& chunk) {
+    unique_lock<mutex> guard(lock);
+    changed.wait(guard, [this] { return chunks.size() < MAX_CHUNKS || stopped; });
+    if (stopped) {
+        return false;
+    }
+    chunks.push_back(std::move(chunk));
+    guard.unlock();
+    changed.notify_all();
+    return true;
+}
+
+void DecompressBuffer::produce() {
+    try {
+        if (type == GZIP) {
+            inflateGzip();
+        }
+        else if (type == ZSTD) {
+            inflateZstd();
+        }
+        else {
+            throw CustomError("Unknown compression format", FILE_ERROR);
+        }
+    }
+    catch (...) {
+        lock_guard<mutex> guard(lock);
+        error = "Error decompressing file";
+    }
+    {
+        lock_guard<mutex> guard(lock);
+        finished = true;
+    }
+    changed.notify_all();
+}
+
+void DecompressBuffer::inflateGzip() {
+#ifdef TSP_ANALYSIS_ZLIB
+    z_stream stream{};
+    // 15 + 32 -> maximum window with automatic gzip/zlib header detection
+    if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+        throw CustomError("zlib initialization failed", FILE_ERROR);
+    }
+    vector<char> input(CHUNK_SIZE);
+    vector<char> output(CHUNK_SIZE);
+    bool reading = true;
+    bool ended = false; /**< Last member read up to its end >**/
+
+    while (reading) {
+        file.read(input.data(), static_cast<streamsize>(input.size()));
+        stream.avail_in = static_cast<uInt>(file.gcount());
+        stream.next_in = reinterpret_cast<Bytef*>(input.data());
+        if (stream.avail_in == 0) {
+            break;
+        }
+        do {
+            stream.avail_out = static_cast<uInt>(output.size());
+            stream.next_out = reinterpret_cast<Bytef*>(output.data());
+            uInt available = stream.avail_in;
+            int status = inflate(&stream, Z_NO_FLUSH);
+            if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR) {
+                inflateEnd(&stream);
+                throw CustomError("Corrupted gzip file", FILE_ERROR);
+            }
+            size_t produced = output.size() - stream.avail_out;
+            if (status == Z_STREAM_END) {
+                ended = true;
+            }
+            else if (produced > 0 || stream.avail_in != available) {
+                ended = false;
+            }
+            if (produced > 0) {
+                vector<char> chunk(output.begin(), output.begin() + static_cast<long>(produced));
+                if (!push(std::move(chunk))) {
+                    reading = false;
+                    break;
+                }
+            }
+            // Concatenated gzip members
+            if (status == Z_STREAM_END) {
+                inflateReset(&stream);
+            }
+            // A full output buffer only means more output is pending while the member is not over
+        } while (stream.avail_in > 0 || (stream.avail_out == 0 && !ended));
+    }
+    inflateEnd(&stream);
+    if (reading && !ended) {
+        throw CustomError("Truncated gzip file", FILE_ERROR);
+    }
+#else
+    throw CustomError("gzip support was not compiled in", FILE_ERROR);
+#endif
+}
+
+void DecompressBuffer::inflateZstd() {
+#ifdef TSP_ANALYSIS_ZSTD
+    ZSTD_DStream* stream = ZSTD_createDStream();
+    if (stream == nullptr) {
+        throw CustomError("zstd initialization failed", FILE_ERROR);
+    }
+    ZSTD_initDStream(stream);
+    vector<char> input(ZSTD_DStreamInSize());
+    vector<char> output(max(ZSTD_DStreamOutSize(), CHUNK_SIZE));
+    bool reading = true;
+    size_t status = 0;
+
+    while (reading) {
+        file.read(input.data(), static_cast<streamsize>(input.size()));
+        ZSTD_inBuffer in = {input.data(), static_cast<size_t>(file.gcount()), 0};
+        if (in.size == 0) {
+            break;
+        }
+        while (in.pos < in.size) {
+            ZSTD_outBuffer out = {output.data(), output.size(), 0};
+            status = ZSTD_decompressStream(stream, &out, &in);
+            if (ZSTD_isError(status)) {
+                ZSTD_freeDStream(stream);
+                throw CustomError("Corrupted zstd file", FILE_ERROR);
+            }
+            if (out.pos > 0) {
+                vector<char> chunk(output.begin(), output.begin() + static_cast<long>(out.pos));
+                if (!push(std::move(chunk))) {
+                    reading = false;
+                    break;
+                }
+            }
+        }
+    }
+    ZSTD_freeDStream(stream);
+    // A non zero hint means that the last frame is incomplete
+    if (reading && status != 0) {
+        throw CustomError("Truncated zstd file", FILE_ERROR);
+    }
+#else
+    throw CustomError("zstd support was not compiled in", FILE_ERROR);
+#endif
+}
+
+DecompressStream::DecompressStream(const string& file_path, COMPRESSION type) : istream(nullptr), buffer(file_path, type) {
+    rdbuf(&buffer);
+}
+
+COMPRESSION DecompressStream::getCompression(const string& file_path) {
+    string extension = filesystem::path(file_path).extension().string();
+    if (extension == ".gz") {
+        return GZIP;
+    }
+    if (extension == ".zst") {
+        return ZSTD;
+    }
+    return NONE;
+}
+
+unique_ptr<istream> DecompressStream::open(const string& file_path) {
+    string path = file_path;
+    if (!filesystem::exists(path)) {
+        if (filesystem::exists(file_path + ".gz")) {
+            path = file_path + ".gz";
+        }
+        else if (filesystem::exists(file_path + ".zst")) {
+            path = file_path + ".zst";
+        }
+        else {
+            return nullptr;
+        }
+    }
+
+    COMPRESSION type = getCompression(path);
+    if (type == NONE) {
+        auto fin = make_unique<ifstream>(path, ios::in);
+        if (!fin->is_open()) {
+            return nullptr;
+        }
+        return fin;
+    }
+    return make_unique<DecompressStream>(path, type);
+}
@@ -0,0 +1,133 @@
+#ifndef TSP_ANALYSIS_DECOMPRESSSTREAM_H
+#define TSP_ANALYSIS_DECOMPRESSSTREAM_H
+
+/**
+ * @file DecompressStream.h
+ * @brief Header for the streaming decompression used by the parser
+ */
+
+/**< STD headers >**/
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Compression formats that the parser can read
+ */
+enum COMPRESSION{
+    NONE,
+    GZIP,
+    ZSTD
+};
+
+/**
+ * @class DecompressBuffer
+ * @brief Stream buffer that is filled by a worker thread decompressing the file.
+ *
+ * The worker decompresses the file in fixed size chunks into a bounded queue, so decompression overlaps with the
+ * tokenizer reading the previous chunk and memory stays constant (no temporary file).
+ */
+class DecompressBuffer : public streambuf {
+public:
+    /**
+     * @constructor DecompressBuffer - opens the file and starts the worker thread
+     * @param file_path - compressed file
+     * @param type - compression format (GZIP or ZSTD)
+     */
+    DecompressBuffer(const string& file_path, COMPRESSION type);
+
+    /**
+     * @destructor DecompressBuffer - stops and joins the worker thread
+     */
+    ~DecompressBuffer() override;
+
+    DecompressBuffer(const DecompressBuffer&) = delete;
+    DecompressBuffer& operator=(const DecompressBuffer&) = delete;
+
+protected:
+    /**
+     * @brief Hands the next decompressed chunk to the reader
+     * @note Throws on a decompression error, the owning istream turns it into badbit
+     * @return next character or eof
+     */
+    int_type underflow() override;
+
+private:
+    /**
+     * @brief Worker thread body
+     */
+    void produce();
+
+    /**
+     * @brief gzip/zlib decompression loop (concatenated members are supported)
+     */
+    void inflateGzip();
+
+    /**
+     * @brief zstd decompression loop (concatenated frames are supported)
+     */
+    void inflateZstd();
+
+    /**
+     * @brief Queue a decompressed chunk, waits while the queue is full
+     * @param chunk - decompressed bytes
+     * @return false if the reader was destroyed and the worker must stop
+     */
+    bool push(vector<char>&& chunk);
+
+    static constexpr size_t CHUNK_SIZE = 1 << 18; /**< Bytes per compressed read and decompressed chunk >**/
+    static constexpr size_t MAX_CHUNKS = 8; /**< Chunks decompressed ahead of the reader >**/
+
+    ifstream file; /**< Compressed file >**/
+    COMPRESSION type; /**< Compression format >**/
+    thread worker; /**< Decompression thread >**/
+    mutex lock; /**< Protects the fields below >**/
+    condition_variable changed; /**< Signals queue changes in both directions >**/
+    deque<vector<char>> chunks; /**< Decompressed chunks waiting for the reader >**/
+    bool finished = false; /**< Worker reached the end of the file >**/
+    bool stopped = false; /**< Reader asked the worker to stop >**/
+    string error; /**< Worker error message, empty if none >**/
+    vector<char> current; /**< Chunk being read >**/
+};
+
+/**
+ * @class DecompressStream
+ * @brief Input stream over a compressed file
+ */
+class DecompressStream : public istream {
+public:
+    /**
+     * @constructor DecompressStream
+     * @param file_path - compressed file
+     * @param type - compression format (GZIP or ZSTD)
+     */
+    DecompressStream(const string& file_path, COMPRESSION type);
+
+    /**
+     * @brief Compression format of a path, by extension (.gz or .zst)
+     * @param file_path
+     * @return compression
+     */
+    static COMPRESSION getCompression(const string& file_path);
+
+    /**
+     * @brief Opens a dataset file, decompressing .gz/.zst files on the fly.
+     * @note If the plain file does not exist but file_path + ".gz" or ".zst" does, the compressed file is used.
+     * @param file_path
+     * @return stream to read, nullptr if the file can't be opened
+     */
+    static unique_ptr<istream> open(const string& file_path);
+
+private:
+    DecompressBuffer buffer; /**< Buffer filled by the worker >**/
+};
+
+#endif //TSP_ANALYSIS_DECOMPRESSSTREAM_H
@@ -46,6 +46,10 @@ int HashTable::getSize() const {
     return size;
 }
 
+int HashTable::getCapacity() const {
+    return capacity;
+}
+
 bool HashTable::isEmpty() const {
     if (size == 0)
         return true;
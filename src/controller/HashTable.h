@@ -80,6 +80,12 @@ public:
      */
     [[nodiscard]] int getSize() const;
 
+    /**
+     * @brief Get the number of slots of the table
+     * @return capacity
+     */
+    [[nodiscard]] int getCapacity() const;
+
     /**
      * @brief Insert bucket into hashTable
      * @param _id - identification of a vertex
@@ -0,0 +1,225 @@
+/**
+ * @file KdTree.cpp
+ * @brief Implementation of the k-d tree
+ */
+
+/**< Project headers >**/
+#include "KdTree.h"
+
+/**< STD headers >**/
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+KdTree::KdTree(vector<Point> _points) : points(std::move(_points)) {
+    order.resize(points.size());
+    iota(order.begin(), order.end(), 0);
+    leaf.assign(points.size(), -1);
+    removed.assign(points.size(), false);
+    if (!points.empty()) {
+        nodes.reserve(2 * points.size() / LEAF + 1);
+        build(0, static_cast<int>(points.size()));
+    }
+}
+
+int KdTree::build(int begin, int end) {
+    int index = static_cast<int>(nodes.size());
+    nodes.push_back({begin, end});
+    nodes[index].count = end - begin;
+    if (end - begin <= LEAF) {
+        for (int i = begin; i < end; i++) {
+            leaf[order[i]] = index;
+        }
+        return index;
+    }
+
+    // Widest axis of the bounding box
+    Point low = points[order[begin]], high = low;
+    for (int i = begin + 1; i < end; i++) {
+        for (int a = 0; a < 3; a++) {
+            low[a] = min(low[a], points[order[i]][a]);
+            high[a] = max(high[a], points[order[i]][a]);
+        }
+    }
+    int axis = 0;
+    for (int a = 1; a < 3; a++) {
+        if (high[a] - low[a] > high[axis] - low[axis]) {
+            axis = a;
+        }
+    }
+
+    int middle = begin + (end - begin) / 2;
+    nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+                [this, axis](int a, int b) { return points[a][axis] < points[b][axis]; });
+    nodes[index].axis = axis;
+    nodes[index].split = points[order[middle]][axis];
+    int left = build(begin, middle);
+    int right = build(middle, end);
+    nodes[index].left = left;
+    nodes[index].right = right;
+    nodes[left].parent = index;
+    nodes[right].parent = index;
+    return index;
+}
+
+double KdTree::squaredDistance(const Point& a, int b) const {
+    double dx = a[0] - points[b][0];
+    double dy = a[1] - points[b][1];
+    double dz = a[2] - points[b][2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+void KdTree::search(int node, const Point& query, int self, size_t k, vector<pair<double, int>>& heap) const {
+    const Node& n = nodes[node];
+    if (n.left == -1) {
+        for (int i = n.begin; i < n.end; i++) {
+            int p = order[i];
+            if (p == self) {
+                continue;
+            }
+            double d = squaredDistance(query, p);
+            if (heap.size() < k) {
+                heap.emplace_back(d, p);
+                push_heap(heap.begin(), heap.end());
+            }
+            else if (d < heap.front().first) {
+                pop_heap(heap.begin(), heap.end());
+                heap.back() = {d, p};
+                push_heap(heap.begin(), heap.end());
+            }
+        }
+        return;
+    }
+
+    double difference = query[n.axis] - n.split;
+    int near = (difference < 0) ? n.left : n.right;
+    int far = (difference < 0) ? n.right : n.left;
+    search(near, query, self, k, heap);
+    if (heap.size() < k || difference * difference < heap.front().first) {
+        search(far, query, self, k, heap);
+    }
+}
+
+void KdTree::nearest(int i, int k, vector<int>& neighbours) const {
+    neighbours.clear();
+    if (nodes.empty() || k <= 0) {
+        return;
+    }
+    vector<pair<double, int>> heap;
+    heap.reserve(k + 1);
+    search(0, points[i], i, static_cast<size_t>(k), heap);
+    sort_heap(heap.begin(), heap.end());
+    for (const auto& entry : heap) {
+        neighbours.push_back(entry.second);
+    }
+}
+
+vector<int> KdTree::nodeLabels(const vector<int>& labels) const {
+    // Children always come after their parent
+    vector<int> node_labels(nodes.size(), -1);
+    for (int i = static_cast<int>(nodes.size()) - 1; i >= 0; i--) {
+        const Node& n = nodes[i];
+        if (n.left != -1) {
+            node_labels[i] = (node_labels[n.left] == node_labels[n.right]) ? node_labels[n.left] : -1;
+            continue;
+        }
+        node_labels[i] = labels[order[n.begin]];
+        for (int p = n.begin + 1; p < n.end; p++) {
+            if (labels[order[p]] != node_labels[i]) {
+                node_labels[i] = -1;
+                break;
+            }
+        }
+    }
+    return node_labels;
+}
+
+void KdTree::searchOther(int node, const Point& query, int label, const vector<int>& labels,
+                         const vector<int>& node_labels, pair<double, int>& best) const {
+    if (node_labels[node] == label) {
+        return;
+    }
+    const Node& n = nodes[node];
+    if (n.left == -1) {
+        for (int i = n.begin; i < n.end; i++) {
+            int p = order[i];
+            if (labels[p] == label) {
+                continue;
+            }
+            double d = squaredDistance(query, p);
+            if (d < best.first) {
+                best = {d, p};
+            }
+        }
+        return;
+    }
+
+    double difference = query[n.axis] - n.split;
+    int near = (difference < 0) ? n.left : n.right;
+    int far = (difference < 0) ? n.right : n.left;
+    searchOther(near, query, label, labels, node_labels, best);
+    if (difference * difference < best.first) {
+        searchOther(far, query, label, labels, node_labels, best);
+    }
+}
+
+int KdTree::nearestOther(int i, const vector<int>& labels, const vector<int>& node_labels) const {
+    pair<double, int> best = {numeric_limits<double>::infinity(), -1};
+    if (!nodes.empty()) {
+        searchOther(0, points[i], labels[i], labels, node_labels, best);
+    }
+    return best.second;
+}
+
+void KdTree::remove(int i) {
+    if (removed[i]) {
+        return;
+    }
+    removed[i] = true;
+    for (int node = leaf[i]; node != -1; node = nodes[node].parent) {
+        nodes[node].count--;
+    }
+}
+
+void KdTree::reset() {
+    fill(removed.begin(), removed.end(), false);
+    for (Node& node : nodes) {
+        node.count = node.end - node.begin;
+    }
+}
+
+void KdTree::searchLeft(int node, const Point& query, int self, pair<double, int>& best) const {
+    const Node& n = nodes[node];
+    if (n.count == 0) {
+        return;
+    }
+    if (n.left == -1) {
+        for (int i = n.begin; i < n.end; i++) {
+            int p = order[i];
+            if (removed[p] || p == self) {
+                continue;
+            }
+            double d = squaredDistance(query, p);
+            if (d < best.first) {
+                best = {d, p};
+            }
+        }
+        return;
+    }
+
+    double difference = query[n.axis] - n.split;
+    int near = (difference < 0) ? n.left : n.right;
+    int far = (difference < 0) ? n.right : n.left;
+    searchLeft(near, query, self, best);
+    if (difference * difference < best.first) {
+        searchLeft(far, query, self, best);
+    }
+}
+
+int KdTree::nearestLeft(int i) const {
+    pair<double, int> best = {numeric_limits<double>::infinity(), -1};
+    if (!nodes.empty()) {
+        searchLeft(0, points[i], i, best);
+    }
+    return best.second;
+}
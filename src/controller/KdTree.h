@@ -0,0 +1,131 @@
+#ifndef TSP_ANALYSIS_KDTREE_H
+#define TSP_ANALYSIS_KDTREE_H
+
+/**
+ * @file KdTree.h
+ * @brief Header for the k-d tree used by the nearest neighbour searches
+ */
+
+/**< STD headers >**/
+#include <array>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+typedef array<double, 3> Point;
+
+/**
+ * @class KdTree
+ * @brief Static k-d tree over 3D points, split on the widest axis at the median with small buckets as leaves.
+ *
+ * Queries only read the tree, so they can run from many threads at once. remove changes it and must not run alongside
+ * them.
+ */
+class KdTree {
+public:
+    /**
+     * @constructor KdTree
+     * @Complexity - O(n log n)
+     * @param points - points, indexed by position
+     */
+    explicit KdTree(vector<Point> points);
+
+    /**
+     * @brief The k points closest to point i (i excluded), closest first
+     * @Complexity - O(k log n) expected
+     * @param i - query point
+     * @param k - number of neighbours
+     * @param neighbours - output, fewer than k if there are not enough points
+     */
+    void nearest(int i, int k, vector<int>& neighbours) const;
+
+    /**
+     * @brief Label of every node whose points all have the same label, -1 for the others (for nearestOther)
+     * @Complexity - O(n)
+     * @param labels - label of every point
+     * @return label of every node
+     */
+    [[nodiscard]] vector<int> nodeLabels(const vector<int>& labels) const;
+
+    /**
+     * @brief The point closest to point i with a label different from the one of i, nodes that only hold its label
+     * are skipped whole
+     * @param i - query point
+     * @param labels - label of every point
+     * @param node_labels - nodeLabels(labels)
+     * @return point, -1 if every point has the label of i
+     */
+    [[nodiscard]] int nearestOther(int i, const vector<int>& labels, const vector<int>& node_labels) const;
+
+    /**
+     * @brief Removes point i from the searches of nearestLeft (the other queries still see every point)
+     * @Complexity - O(log n)
+     * @param i - point
+     */
+    void remove(int i);
+
+    /**
+     * @brief Puts back every removed point
+     * @Complexity - O(n)
+     */
+    void reset();
+
+    /**
+     * @brief The point closest to point i among the ones not removed, subtrees with no point left are skipped whole
+     * @Complexity - O(log n) expected
+     * @param i - query point, excluded even if not removed
+     * @return point, -1 if every other point was removed
+     */
+    [[nodiscard]] int nearestLeft(int i) const;
+
+private:
+    /**
+     * @struct Node
+     * @brief Leaf (points order[begin, end)) or split on axis at value, children left / right
+     */
+    struct Node {
+        int begin;
+        int end;
+        int left = -1;
+        int right = -1;
+        int axis = 0;
+        double split = 0;
+        int parent = -1;
+        int count = 0; /**< Points not removed >**/
+    };
+
+    /**
+     * @brief Builds the subtree over order[begin, end)
+     * @return node index
+     */
+    int build(int begin, int end);
+
+    /**
+     * @brief Visits the node closest side first, heap holds the k best (squared distance, point) found so far
+     */
+    void search(int node, const Point& query, int self, size_t k, vector<pair<double, int>>& heap) const;
+
+    /**
+     * @brief Same as search for one neighbour with a label other than label
+     */
+    void searchOther(int node, const Point& query, int label, const vector<int>& labels, const vector<int>& node_labels,
+                     pair<double, int>& best) const;
+
+    /**
+     * @brief Same as search for one neighbour that was not removed
+     */
+    void searchLeft(int node, const Point& query, int self, pair<double, int>& best) const;
+
+    [[nodiscard]] double squaredDistance(const Point& a, int b) const;
+
+    static constexpr int LEAF = 8; /**< Points per leaf >**/
+
+    vector<Point> points; /**< Points >**/
+    vector<int> order; /**< Point indices, every node owns a contiguous range >**/
+    vector<Node> nodes; /**< Nodes, the root is the first one >**/
+    vector<int> leaf; /**< Leaf of every point >**/
+    vector<char> removed; /**< Points removed >**/
+};
+
+#endif //TSP_ANALYSIS_KDTREE_H
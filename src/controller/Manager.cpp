@@ -1,4 +1,12 @@
 #include "Manager.h"
+/**< STD headers >**/
+#include <filesystem>
+#include <memory>
+
+string DatasetSource::getKey() const {
+    return vertices_path + "|" + edges_path + "|" + to_string(number_of_vertices) + "|" +
+           to_string(symmetric_or_real) + "|" + to_string(tsplib);
+}
 
 Manager::Manager() {
     this->graph = new Graph();
@@ -8,9 +16,27 @@ Manager::Manager() {
 }
 
 Manager::~Manager() {
+    // Wait for preloads and delete them
+    for (auto& preload : preloads) {
+        try {
+            Dataset dataset = preload.second.get();
+            delete dataset.vertices_table;
+            delete dataset.graph;
+        }
+        catch (...) {
+            // A failed preload already deleted what it built and nobody used it
+        }
+    }
+    // Delete resident datasets (the current one is resident unless current_key is empty)
+    for (auto& entry : resident) {
+        delete entry.dataset.vertices_table;
+        delete entry.dataset.graph;
+    }
     // Delete graph/parser/hash_table
-    delete this->vertices_table;
-    delete this->graph;
+    if (current_key.empty()) {
+        delete this->vertices_table;
+        delete this->graph;
+    }
     delete this->parser;
     delete this->coder;
 }
@@ -31,15 +57,205 @@ Coder* Manager::getCoder() const {
     return this->coder;
 }
 
-void Manager::callParserImportFiles(const string &vertices_path, int number_of_vertices, const string &edges_path,bool symmetric_or_real) {
-    delete this->vertices_table;
-    delete this->graph;
-    this->graph = new Graph();
-    this->vertices_table = new HashTable(number_of_vertices);
+Dataset Manager::loadDataset(const DatasetSource& source) {
+    Parser loader;
+    int n = source.tsplib ? Parser::readTSPLIBDimension(source.vertices_path) : source.number_of_vertices;
+    // Owned here until the import succeeds, a throwing import deletes them
+    auto graph = make_unique<Graph>();
+    auto table = make_unique<HashTable>(n);
+    loader.setNewGraph(graph.get());
+    loader.setNewTable(table.get());
+    if (source.tsplib) {
+        loader.importTSPLIB(source.vertices_path);
+    }
+    else {
+        loader.importFiles(source.vertices_path, n, source.edges_path, source.symmetric_or_real);
+    }
+    Dataset dataset;
+    dataset.graph = graph.release();
+    dataset.vertices_table = table.release();
+    return dataset;
+}
+
+void Manager::swapDataset(Dataset dataset, const string& key) {
+    Graph* old_graph = this->graph;
+    HashTable* old_table = this->vertices_table;
+    bool old_resident = !current_key.empty();
+    this->graph = dataset.graph;
+    this->vertices_table = dataset.vertices_table;
+    this->current_key = key;
     this->parser->setNewTable(vertices_table);
     this->parser->setNewGraph(graph);
     this->coder->setNewTable(vertices_table);
     this->coder->setNewGraph(graph);
-    parser->importFiles(vertices_path,number_of_vertices,edges_path,symmetric_or_real);
+    if (!old_resident && old_graph != graph) {
+        delete old_table;
+        delete old_graph;
+    }
+}
+
+string Manager::getFingerprint(const DatasetSource& source) {
+    string fingerprint;
+    for (const string& path : {source.vertices_path, source.edges_path}) {
+        if (path.empty()) {
+            continue;
+        }
+        // Same fallback as the parser for compressed copies
+        string file = path;
+        for (const string& candidate : {path, path + ".gz", path + ".zst"}) {
+            if (filesystem::exists(candidate)) {
+                file = candidate;
+                break;
+            }
+        }
+        error_code error;
+        auto size = filesystem::file_size(file, error);
+        if (error) {
+            return "";
+        }
+        auto time = filesystem::last_write_time(file, error).time_since_epoch().count();
+        fingerprint += file + ":" + to_string(size) + ":" + to_string(time) + ";";
+    }
+    return fingerprint;
+}
+
+size_t Manager::estimateMemory(const Dataset& dataset) {
+    size_t memory = sizeof(Graph) + sizeof(Metric) + dataset.graph->getMetric()->getMemoryUsage();
+    for (const Vertex* v : dataset.graph->getVertexSet()) {
+        memory += sizeof(Vertex) + sizeof(Vertex*) + v->getLabel().capacity();
+        if (v->getCoordinates() != nullptr) {
+            memory += sizeof(Coordinate);
+        }
+        // Outgoing edges own the Edge, incoming only hold a pointer
+        memory += static_cast<size_t>(v->getOutDegree()) * (sizeof(Edge) + sizeof(Edge*));
+        memory += static_cast<size_t>(v->getInDegree()) * sizeof(Edge*);
+    }
+    memory += sizeof(HashTable) + static_cast<size_t>(dataset.vertices_table->getCapacity()) * sizeof(HashBucket*);
+    memory += static_cast<size_t>(dataset.vertices_table->getSize()) * sizeof(HashBucket);
+    return memory;
+}
+
+void Manager::evictDatasets() {
+    auto it = resident.end();
+    while (resident_memory > memory_budget && it != resident.begin()) {
+        --it;
+        if (it->key == current_key) {
+            continue;
+        }
+        resident_memory -= it->memory;
+        delete it->dataset.vertices_table;
+        delete it->dataset.graph;
+        resident_index.erase(it->key);
+        it = resident.erase(it);
+    }
+}
+
+void Manager::setMemoryBudget(size_t bytes) {
+    memory_budget = bytes;
+    evictDatasets();
+}
+
+size_t Manager::getResidentMemory() const {
+    return resident_memory;
+}
+
+bool Manager::isResident(const DatasetSource& source) const {
+    auto it = resident_index.find(source.getKey());
+    return it != resident_index.end() && it->second->fingerprint == getFingerprint(source);
+}
+
+void Manager::preloadDataset(const DatasetSource& source) {
+    if (isResident(source)) {
+        return;
+    }
+    lock_guard<mutex> guard(preload_lock);
+    string key = source.getKey();
+    if (preloads.find(key) == preloads.end()) {
+        preloads.emplace(key, async(launch::async, &Manager::loadDataset, source));
+    }
+}
+
+bool Manager::isPreloadReady(const DatasetSource& source) const {
+    lock_guard<mutex> guard(preload_lock);
+    auto it = preloads.find(source.getKey());
+    return it != preloads.end() && it->second.wait_for(chrono::seconds(0)) == future_status::ready;
 }
 
+void Manager::useDataset(const DatasetSource& source) {
+    string key = source.getKey();
+    string fingerprint = getFingerprint(source);
+
+    // Algorithms can add edges, so the estimate of the current dataset is refreshed before it stops being used
+    if (!current_key.empty()) {
+        ResidentDataset& current = *resident_index[current_key];
+        resident_memory -= current.memory;
+        current.memory = estimateMemory(current.dataset);
+        resident_memory += current.memory;
+    }
+
+    // Resident and unchanged -> no import
+    auto found = resident_index.find(key);
+    if (found != resident_index.end()) {
+        if (found->second->fingerprint == fingerprint && !fingerprint.empty()) {
+            resident.splice(resident.begin(), resident, found->second);
+            swapDataset(found->second->dataset, key);
+            return;
+        }
+        // Files changed, the old copy is dropped once it is not the current one
+        ResidentDataset stale = *found->second;
+        resident.erase(found->second);
+        resident_index.erase(found);
+        resident_memory -= stale.memory;
+        if (stale.key == current_key) {
+            current_key.clear();
+        }
+        else {
+            delete stale.dataset.vertices_table;
+            delete stale.dataset.graph;
+        }
+    }
+
+    future<Dataset> preload;
+    {
+        lock_guard<mutex> guard(preload_lock);
+        auto it = preloads.find(key);
+        if (it != preloads.end()) {
+            preload = std::move(it->second);
+            preloads.erase(it);
+        }
+    }
+    // A failed import (here or in the preload) is rethrown before anything is swapped
+    Dataset dataset = preload.valid() ? preload.get() : loadDataset(source);
+
+    swapDataset(dataset, "");
+    if (!fingerprint.empty()) {
+        size_t memory = estimateMemory(dataset);
+        resident.push_front({key, fingerprint, dataset, memory});
+        resident_index[key] = resident.begin();
+        resident_memory += memory;
+        current_key = key;
+        evictDatasets();
+    }
+}
+
+void Manager::sweep(const vector<DatasetSource>& sources, const function<void(const DatasetSource&)>& job) {
+    if (sources.empty()) {
+        return;
+    }
+    preloadDataset(sources.front());
+    for (size_t i = 0; i < sources.size(); i++) {
+        useDataset(sources[i]);
+        if (i + 1 < sources.size()) {
+            preloadDataset(sources[i + 1]);
+        }
+        job(sources[i]);
+    }
+}
+
+void Manager::callParserImportFiles(const string &vertices_path, int number_of_vertices, const string &edges_path,bool symmetric_or_real) {
+    useDataset({vertices_path, number_of_vertices, edges_path, symmetric_or_real, false});
+}
+
+void Manager::callParserImportTSPLIB(const string &file_path) {
+    useDataset({file_path, 0, "", true, true});
+}
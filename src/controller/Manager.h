@@ -11,8 +11,59 @@
 #include "HashTable.h"
 #include "Coder.h"
 /**< STD headers >**/
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
 #include <unordered_map>
 
+/**
+ * @struct DatasetSource
+ * @brief Files (and import options) of a dataset
+ * @param vertices_path - vertices file, or the only file (edges with vertices / TSPLIB)
+ * @param number_of_vertices - number of vertices (ignored for TSPLIB, read from the header)
+ * @param edges_path - edges file, empty if the vertices file has the edges
+ * @param symmetric_or_real - True - symmetric, False - real
+ * @param tsplib - vertices_path is a TSPLIB instance
+ */
+struct DatasetSource {
+    string vertices_path;
+    int number_of_vertices = 0;
+    string edges_path;
+    bool symmetric_or_real = true;
+    bool tsplib = false;
+
+    /**
+     * @brief Identification of the source (paths and options)
+     * @return key
+     */
+    [[nodiscard]] string getKey() const;
+};
+
+/**
+ * @struct Dataset
+ * @brief Graph and vertices table built from a DatasetSource
+ */
+struct Dataset {
+    Graph* graph = nullptr;
+    HashTable* vertices_table = nullptr;
+};
+
+/**
+ * @struct ResidentDataset
+ * @brief Dataset kept in memory by the manager registry
+ * @param key - DatasetSource key
+ * @param fingerprint - size and modification time of the files when imported
+ * @param dataset - graph and table
+ * @param memory - estimated bytes used by the dataset
+ */
+struct ResidentDataset {
+    string key;
+    string fingerprint;
+    Dataset dataset;
+    size_t memory = 0;
+};
+
 /**
  * @note Our way of doing multiple managers, respects the SRP- Single responsibility principle
  */
@@ -51,6 +102,65 @@ public:
 
      void callParserImportFiles(const string& vertices_path, int number_of_vertices, const string& edges_path, bool symmetric_or_real);
 
+    /**
+     * @brief Import a TSPLIB instance (.tsp/.atsp) into a new graph
+     * @param file_path - TSPLIB file path
+     */
+     void callParserImportTSPLIB(const string& file_path);
+
+    /**
+     * @brief Start loading a dataset on a worker thread, the current graph stays in use.
+     * @note Does nothing if the same source is already being loaded
+     * @param source - dataset files
+     */
+     void preloadDataset(const DatasetSource& source);
+
+    /**
+     * @brief Check if a preloaded dataset finished loading
+     * @param source - dataset files
+     * @return true if the preload exists and is ready, else false
+     */
+     [[nodiscard]] bool isPreloadReady(const DatasetSource& source) const;
+
+    /**
+     * @brief Make a dataset the current one.
+     *
+     * A resident dataset with the same fingerprint is reused without importing. Otherwise a preloaded dataset is taken
+     * (waiting only for what is left of its import) or it is imported now, and it becomes resident.
+     * The old graph is used until the new one is complete, then both are swapped at once.
+     * @note Throws the CustomError of a failed import (a failed preload included), the old graph stays the current one
+     *
+     * @param source - dataset files
+     */
+     void useDataset(const DatasetSource& source);
+
+    /**
+     * @brief Run a job on every dataset, loading the next one in the background while the job runs
+     * @param sources - datasets in order
+     * @param job - called with each source once it is the current dataset
+     */
+     void sweep(const vector<DatasetSource>& sources, const function<void(const DatasetSource&)>& job);
+
+    /**
+     * @brief Set the memory budget of the resident datasets, least recently used datasets are evicted above it
+     * @note The current dataset is never evicted, even if it alone is above the budget
+     * @param bytes - budget in bytes
+     */
+     void setMemoryBudget(size_t bytes);
+
+    /**
+     * @brief Get the estimated memory used by the resident datasets
+     * @return bytes
+     */
+     [[nodiscard]] size_t getResidentMemory() const;
+
+    /**
+     * @brief Check if a dataset is resident and its files did not change since the import
+     * @param source - dataset files
+     * @return true if useDataset will not import it
+     */
+     [[nodiscard]] bool isResident(const DatasetSource& source) const;
+
 
     /**
      * @destructor Destructor for class manager
@@ -58,10 +168,56 @@ public:
     ~Manager();
 
 private:
+    /**
+     * @brief Import a dataset into a new graph and table
+     * @note Uses its own parser, so it can run on a worker thread. Errors are thrown, never exit the program
+     * @param source - dataset files
+     * @return dataset
+     */
+    static Dataset loadDataset(const DatasetSource& source);
+
+    /**
+     * @brief Make the dataset the current one
+     * @note The previous one is deleted only if it is not resident
+     * @param dataset - new dataset
+     * @param key - source key of the dataset
+     */
+    void swapDataset(Dataset dataset, const string& key);
+
+    /**
+     * @brief Fingerprint of the dataset files (size and modification time of each file)
+     * @param source - dataset files
+     * @return fingerprint, empty if a file is missing
+     */
+    static string getFingerprint(const DatasetSource& source);
+
+    /**
+     * @brief Estimate the memory used by a dataset (vertices, edges, table and explicit matrix)
+     * @param dataset
+     * @return bytes
+     */
+    static size_t estimateMemory(const Dataset& dataset);
+
+    /**
+     * @brief Evict least recently used datasets (never the current one) until the budget is respected
+     */
+    void evictDatasets();
+
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = size_t(1) << 30; /**< 1 GiB >**/
+
     Parser* parser; /**< Parser >**/
     Graph* graph;  /**< Graph >**/
     HashTable* vertices_table; /**< Vertices table >**/
     Coder* coder; /**< Coder >**/
+
+    mutable mutex preload_lock; /**< Protects preloads >**/
+    unordered_map<string, future<Dataset>> preloads; /**< Datasets being loaded, by source key >**/
+
+    list<ResidentDataset> resident; /**< Resident datasets, most recently used first >**/
+    unordered_map<string, list<ResidentDataset>::iterator> resident_index; /**< Resident datasets by source key >**/
+    string current_key; /**< Source key of the current dataset, empty if it is not resident >**/
+    size_t memory_budget = DEFAULT_MEMORY_BUDGET; /**< Memory budget of the resident datasets >**/
+    size_t resident_memory = 0; /**< Estimated memory of the resident datasets >**/
 };
 
-#endif //TSP_ANALYSIS_MANAGER_H
\ No newline at end of file
+#endif //TSP_ANALYSIS_MANAGER_H
@@ -0,0 +1,493 @@
+/**
+ * @file Matching.cpp
+ * @brief Implementation of the perfect matchings
+ */
+
+/**< Project headers >**/
+#include "Matching.h"
+#include "ThreadPool.h"
+
+/**< STD headers >**/
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+
+static constexpr double INF = numeric_limits<double>::infinity();
+
+namespace {
+
+/**
+ * @struct BlossomEdge
+ * @brief Edge u - v of weight w, for a blossom row it is the original edge that reaches the blossom
+ */
+struct BlossomEdge {
+    int u;
+    int v;
+    long long w;
+};
+
+/**
+ * @class Blossom
+ * @brief Maximum weight matching of a general graph (Edmonds blossom algorithm with dual labels, O(n^3)).
+ *
+ * Vertices are 1..n, blossoms n + 1..2n and 0 stands for none. An edge of weight 0 does not exist.
+ */
+class Blossom {
+public:
+    explicit Blossom(int vertices) : n(vertices), n_x(vertices), size(2 * vertices + 1) {
+        g.resize(static_cast<size_t>(size) * size);
+        for (int u = 1; u <= n; u++) {
+            for (int v = 1; v <= n; v++) {
+                edge(u, v) = {u, v, 0};
+            }
+        }
+        lab.assign(size, 0);
+        match.assign(size, 0);
+        slack.assign(size, 0);
+        st.assign(size, 0);
+        pa.assign(size, 0);
+        S.assign(size, 0);
+        vis.assign(size, 0);
+        flower_from.assign(static_cast<size_t>(size) * (n + 1), 0);
+        flower.resize(size);
+    }
+
+    void setWeight(int u, int v, long long w) {
+        edge(u, v).w = w;
+        edge(v, u).w = w;
+    }
+
+    void solve() {
+        n_x = n;
+        long long w_max = 0;
+        for (int u = 0; u <= n; u++) {
+            st[u] = u;
+            flower[u].clear();
+        }
+        for (int u = 1; u <= n; u++) {
+            for (int v = 1; v <= n; v++) {
+                from(u, v) = (u == v) ? u : 0;
+                w_max = max(w_max, edge(u, v).w);
+            }
+        }
+        for (int u = 1; u <= n; u++) {
+            lab[u] = w_max;
+        }
+        while (augmentingPath()) {}
+    }
+
+    [[nodiscard]] int mateOf(int u) const { return match[u]; }
+
+private:
+    BlossomEdge& edge(int u, int v) { return g[static_cast<size_t>(u) * size + v]; }
+    int& from(int b, int x) { return flower_from[static_cast<size_t>(b) * (n + 1) + x]; }
+    [[nodiscard]] long long dist(const BlossomEdge& e) const { return lab[e.u] + lab[e.v] - e.w * 2; }
+
+    // edge(x, u) is edge(u, x) seen from the other side (same weight and labels), the row of x is contiguous
+    void updateSlack(int u, int x) {
+        if (!slack[x] || dist(edge(x, u)) < dist(edge(x, slack[x]))) {
+            slack[x] = u;
+        }
+    }
+
+    void setSlack(int x) {
+        slack[x] = 0;
+        const BlossomEdge* row = &edge(x, 0);
+        for (int u = 1; u <= n; u++) {
+            if (row[u].w > 0 && st[u] != x && S[st[u]] == 0) {
+                updateSlack(u, x);
+            }
+        }
+    }
+
+    void push(int x) {
+        if (x <= n) {
+            q.push(x);
+            return;
+        }
+        for (int y : flower[x]) {
+            push(y);
+        }
+    }
+
+    void setTop(int x, int b) {
+        st[x] = b;
+        if (x > n) {
+            for (int y : flower[x]) {
+                setTop(y, b);
+            }
+        }
+    }
+
+    int evenPosition(int b, int xr) {
+        int pr = static_cast<int>(find(flower[b].begin(), flower[b].end(), xr) - flower[b].begin());
+        if (pr % 2 == 1) {
+            reverse(flower[b].begin() + 1, flower[b].end());
+            return static_cast<int>(flower[b].size()) - pr;
+        }
+        return pr;
+    }
+
+    void setMatch(int u, int v) {
+        match[u] = edge(u, v).v;
+        if (u > n) {
+            BlossomEdge e = edge(u, v);
+            int xr = from(u, e.u), pr = evenPosition(u, xr);
+            for (int i = 0; i < pr; i++) {
+                setMatch(flower[u][i], flower[u][i ^ 1]);
+            }
+            setMatch(xr, v);
+            rotate(flower[u].begin(), flower[u].begin() + pr, flower[u].end());
+        }
+    }
+
+    void augment(int u, int v) {
+        while (true) {
+            int xnv = st[match[u]];
+            setMatch(u, v);
+            if (!xnv) {
+                return;
+            }
+            setMatch(xnv, st[pa[xnv]]);
+            u = st[pa[xnv]];
+            v = xnv;
+        }
+    }
+
+    int lowestCommonAncestor(int u, int v) {
+        for (++vis_time; u || v; swap(u, v)) {
+            if (u == 0) {
+                continue;
+            }
+            if (vis[u] == vis_time) {
+                return u;
+            }
+            vis[u] = vis_time;
+            u = st[match[u]];
+            if (u) {
+                u = st[pa[u]];
+            }
+        }
+        return 0;
+    }
+
+    void addBlossom(int u, int lca, int v) {
+        int b = n + 1;
+        while (b <= n_x && st[b]) {
+            b++;
+        }
+        if (b > n_x) {
+            n_x++;
+        }
+        lab[b] = 0;
+        S[b] = 0;
+        match[b] = match[lca];
+        flower[b].clear();
+        flower[b].push_back(lca);
+        for (int x = u, y; x != lca; x = st[pa[y]]) {
+            flower[b].push_back(x);
+            flower[b].push_back(y = st[match[x]]);
+            push(y);
+        }
+        reverse(flower[b].begin() + 1, flower[b].end());
+        for (int x = v, y; x != lca; x = st[pa[y]]) {
+            flower[b].push_back(x);
+            flower[b].push_back(y = st[match[x]]);
+            push(y);
+        }
+        setTop(b, b);
+        for (int x = 1; x <= n_x; x++) {
+            edge(b, x).w = 0;
+            edge(x, b).w = 0;
+        }
+        for (int x = 1; x <= n; x++) {
+            from(b, x) = 0;
+        }
+        for (int xs : flower[b]) {
+            for (int x = 1; x <= n_x; x++) {
+                if (edge(b, x).w == 0 || dist(edge(xs, x)) < dist(edge(b, x))) {
+                    edge(b, x) = edge(xs, x);
+                    edge(x, b) = edge(x, xs);
+                }
+            }
+            for (int x = 1; x <= n; x++) {
+                if (from(xs, x)) {
+                    from(b, x) = xs;
+                }
+            }
+        }
+        setSlack(b);
+    }
+
+    void expandBlossom(int b) {
+        for (int x : flower[b]) {
+            setTop(x, x);
+        }
+        int xr = from(b, edge(b, pa[b]).u), pr = evenPosition(b, xr);
+        for (int i = 0; i < pr; i += 2) {
+            int xs = flower[b][i], xns = flower[b][i + 1];
+            pa[xs] = edge(xns, xs).u;
+            S[xs] = 1;
+            S[xns] = 0;
+            slack[xs] = 0;
+            setSlack(xns);
+            push(xns);
+        }
+        S[xr] = 1;
+        pa[xr] = pa[b];
+        for (size_t i = pr + 1; i < flower[b].size(); i++) {
+            int xs = flower[b][i];
+            S[xs] = -1;
+            setSlack(xs);
+        }
+        st[b] = 0;
+    }
+
+    bool onTightEdge(const BlossomEdge& e) {
+        int u = st[e.u], v = st[e.v];
+        if (S[v] == -1) {
+            pa[v] = e.u;
+            S[v] = 1;
+            int nu = st[match[v]];
+            slack[v] = slack[nu] = 0;
+            S[nu] = 0;
+            push(nu);
+        }
+        else if (S[v] == 0) {
+            int lca = lowestCommonAncestor(u, v);
+            if (!lca) {
+                augment(u, v);
+                augment(v, u);
+                return true;
+            }
+            addBlossom(u, lca, v);
+        }
+        return false;
+    }
+
+    /**
+     * @brief Grows alternating trees from the free vertices, adjusting the labels, until one augmenting path is found
+     * @return false if the matching can't grow
+     */
+    bool augmentingPath() {
+        fill(S.begin() + 1, S.begin() + n_x + 1, -1);
+        fill(slack.begin() + 1, slack.begin() + n_x + 1, 0);
+        q = queue<int>();
+        for (int x = 1; x <= n_x; x++) {
+            if (st[x] == x && !match[x]) {
+                pa[x] = 0;
+                S[x] = 0;
+                push(x);
+            }
+        }
+        if (q.empty()) {
+            return false;
+        }
+        while (true) {
+            while (!q.empty()) {
+                int u = q.front();
+                q.pop();
+                if (S[st[u]] == 1) {
+                    continue;
+                }
+                for (int v = 1; v <= n; v++) {
+                    if (edge(u, v).w > 0 && st[u] != st[v]) {
+                        if (dist(edge(u, v)) == 0) {
+                            if (onTightEdge(edge(u, v))) {
+                                return true;
+                            }
+                        }
+                        else {
+                            updateSlack(u, st[v]);
+                        }
+                    }
+                }
+            }
+
+            long long d = numeric_limits<long long>::max();
+            for (int b = n + 1; b <= n_x; b++) {
+                if (st[b] == b && S[b] == 1) {
+                    d = min(d, lab[b] / 2);
+                }
+            }
+            for (int x = 1; x <= n_x; x++) {
+                if (st[x] == x && slack[x]) {
+                    if (S[x] == -1) {
+                        d = min(d, dist(edge(slack[x], x)));
+                    }
+                    else if (S[x] == 0) {
+                        d = min(d, dist(edge(slack[x], x)) / 2);
+                    }
+                }
+            }
+            for (int u = 1; u <= n; u++) {
+                if (S[st[u]] == 0) {
+                    if (lab[u] <= d) {
+                        return false;
+                    }
+                    lab[u] -= d;
+                }
+                else if (S[st[u]] == 1) {
+                    lab[u] += d;
+                }
+            }
+            for (int b = n + 1; b <= n_x; b++) {
+                if (st[b] == b) {
+                    if (S[st[b]] == 0) {
+                        lab[b] += d * 2;
+                    }
+                    else if (S[st[b]] == 1) {
+                        lab[b] -= d * 2;
+                    }
+                }
+            }
+
+            q = queue<int>();
+            for (int x = 1; x <= n_x; x++) {
+                if (st[x] == x && slack[x] && st[slack[x]] != x && dist(edge(slack[x], x)) == 0) {
+                    if (onTightEdge(edge(slack[x], x))) {
+                        return true;
+                    }
+                }
+            }
+            for (int b = n + 1; b <= n_x; b++) {
+                if (st[b] == b && S[b] == 1 && lab[b] == 0) {
+                    expandBlossom(b);
+                }
+            }
+        }
+    }
+
+    int n; /**< Vertices >**/
+    int n_x; /**< Vertices and blossoms in use >**/
+    int size; /**< Rows of the tables (2n + 1) >**/
+    vector<BlossomEdge> g; /**< Edge between any two vertices / blossoms >**/
+    vector<long long> lab; /**< Dual labels >**/
+    vector<int> match; /**< Matched vertex >**/
+    vector<int> slack; /**< Vertex of the tightest edge to each blossom >**/
+    vector<int> st; /**< Outermost blossom of each vertex >**/
+    vector<int> pa; /**< Parent in the alternating tree >**/
+    vector<int> S; /**< -1 unreached, 0 even, 1 odd >**/
+    vector<int> vis; /**< Marks of lowestCommonAncestor >**/
+    int vis_time = 0; /**< Current mark >**/
+    vector<int> flower_from; /**< Sub blossom of each blossom that holds a vertex >**/
+    vector<vector<int>> flower; /**< Sub blossoms of each blossom, in cycle order >**/
+    queue<int> q; /**< Even vertices to scan >**/
+};
+
+}
+
+size_t Matching::optimalMemory(int k) {
+    auto size = static_cast<size_t>(2 * k + 1);
+    return size * size * sizeof(BlossomEdge) + size * (k + 1) * sizeof(int) + static_cast<size_t>(k) * k * sizeof(double);
+}
+
+bool Matching::optimal(int k, const PairDistance& distance, vector<int>& mate, int threads) {
+    mate.assign(k, -1);
+    if (k % 2 != 0) {
+        return false;
+    }
+    if (k == 0) {
+        return true;
+    }
+
+    vector<double> weights(static_cast<size_t>(k) * k, INF);
+    ThreadPool pool(threads);
+    pool.parallelFor(0, k, 16, [&](size_t begin, size_t end, int) {
+        for (size_t i = begin; i < end; i++) {
+            for (size_t j = i + 1; j < static_cast<size_t>(k); j++) {
+                double d = distance(static_cast<int>(i), static_cast<int>(j));
+                weights[i * k + j] = d;
+                weights[j * k + i] = d;
+            }
+        }
+    });
+
+    // Maximum weight of (big - distance): big is so large that a perfect matching always beats a smaller one
+    double longest = 0;
+    for (double d : weights) {
+        if (d != INF) {
+            longest = max(longest, d);
+        }
+    }
+    double scale = (longest > 0) ? WEIGHT_SCALE / longest : 1;
+    long long big = (k / 2 + 1) * llround(longest * scale) + 1;
+    Blossom blossom(k);
+    for (int i = 0; i < k; i++) {
+        for (int j = i + 1; j < k; j++) {
+            double d = weights[static_cast<size_t>(i) * k + j];
+            if (d != INF) {
+                blossom.setWeight(i + 1, j + 1, big - llround(d * scale));
+            }
+        }
+    }
+    blossom.solve();
+
+    for (int i = 0; i < k; i++) {
+        int m = blossom.mateOf(i + 1);
+        if (m == 0) {
+            mate.assign(k, -1);
+            return false;
+        }
+        mate[i] = m - 1;
+    }
+    return true;
+}
+
+bool Matching::greedy(int k, const PairDistance& distance, vector<int>& mate, int threads) {
+    mate.assign(k, -1);
+    if (k % 2 != 0) {
+        return false;
+    }
+
+    struct Pair {
+        double distance;
+        int a;
+        int b;
+    };
+    ThreadPool pool(threads);
+    vector<int> left(k);
+    iota(left.begin(), left.end(), 0);
+    while (!left.empty()) {
+        size_t m = left.size();
+        size_t candidates = min(static_cast<size_t>(CANDIDATES), m - 1);
+        vector<Pair> pairs(m * candidates);
+        pool.parallelFor(0, m, 64, [&](size_t begin, size_t end, int) {
+            vector<pair<double, int>> row(m);
+            for (size_t i = begin; i < end; i++) {
+                for (size_t j = 0; j < m; j++) {
+                    row[j] = {(i == j) ? INF : distance(left[i], left[j]), static_cast<int>(j)};
+                }
+                nth_element(row.begin(), row.begin() + static_cast<long>(candidates) - 1, row.end());
+                for (size_t c = 0; c < candidates; c++) {
+                    int a = left[i], b = left[row[c].second];
+                    pairs[i * candidates + c] = {row[c].first, min(a, b), max(a, b)};
+                }
+            }
+        });
+
+        sort(pairs.begin(), pairs.end(), [](const Pair& x, const Pair& y) {
+            return x.distance < y.distance || (x.distance == y.distance && (x.a < y.a || (x.a == y.a && x.b < y.b)));
+        });
+        bool matched = false;
+        for (const Pair& p : pairs) {
+            if (p.distance == INF) {
+                break;
+            }
+            if (mate[p.a] == -1 && mate[p.b] == -1) {
+                mate[p.a] = p.b;
+                mate[p.b] = p.a;
+                matched = true;
+            }
+        }
+        if (!matched) {
+            mate.assign(k, -1);
+            return false;
+        }
+        // The points left lost their candidates, they are matched again among themselves
+        left.erase(remove_if(left.begin(), left.end(), [&mate](int v) { return mate[v] != -1; }), left.end());
+    }
+    return true;
+}
@@ -0,0 +1,73 @@
+#ifndef TSP_ANALYSIS_MATCHING_H
+#define TSP_ANALYSIS_MATCHING_H
+
+/**
+ * @file Matching.h
+ * @brief Header for the minimum weight perfect matchings used by Christofides
+ */
+
+/**< STD headers >**/
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Perfect matching algorithms
+ */
+enum MATCHING_TYPE{
+    OPTIMAL_MATCHING, /**< Minimum weight (Edmonds blossom), O(k^3) >**/
+    GREEDY_MATCHING   /**< Cheapest pair first over the nearest candidates of each vertex, O(k^2) >**/
+};
+
+typedef function<double(int, int)> PairDistance;
+
+/**
+ * @class Matching
+ * @brief Perfect matchings of k points (k even) given a symmetric distance between any two of them.
+ *
+ * Distances are requested in parallel from a thread pool, so the distance function must be safe to call from many
+ * threads. An infinite distance means the pair can't be matched.
+ */
+class Matching {
+public:
+    /**
+     * @brief Minimum weight perfect matching (weighted blossom with dual labels)
+     * @note Distances are scaled to integers (about 6 significant digits), so the weight is optimal up to that rounding
+     * @Complexity - O(k^3) time, O(k^2) memory
+     * @param k - number of points
+     * @param distance - distance between two points
+     * @param mate - point matched to each point
+     * @param threads - threads filling the weights, 0 uses the hardware concurrency
+     * @return false if there is no perfect matching
+     */
+    static bool optimal(int k, const PairDistance& distance, vector<int>& mate, int threads = 0);
+
+    /**
+     * @brief Greedy perfect matching: the candidates are the nearest points of each point, pairs are taken cheapest
+     * first and the points left are matched again among themselves until none is left
+     * @Complexity - O(k^2) distances, computed in parallel
+     * @param k - number of points
+     * @param distance - distance between two points
+     * @param mate - point matched to each point
+     * @param threads - threads computing the candidates, 0 uses the hardware concurrency
+     * @return false if there is no perfect matching
+     */
+    static bool greedy(int k, const PairDistance& distance, vector<int>& mate, int threads = 0);
+
+    /**
+     * @brief Memory needed by the blossom tables
+     * @param k - number of points
+     * @return bytes
+     */
+    static size_t optimalMemory(int k);
+
+    static constexpr int OPTIMAL_MAX_SIZE = 1000; /**< Largest number of points given to the blossom (k^3 time) >**/
+
+private:
+    static constexpr int CANDIDATES = 8; /**< Nearest points of each point tried by the greedy matching >**/
+    static constexpr double WEIGHT_SCALE = 1e6; /**< Integer value of the largest distance in the blossom >**/
+};
+
+#endif //TSP_ANALYSIS_MATCHING_H
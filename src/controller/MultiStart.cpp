@@ -0,0 +1,194 @@
+/**
+ * @file MultiStart.cpp
+ * @brief Implementation of the read-only graph copy used by the multi-start constructions
+ */
+
+/**< Project headers >**/
+#include "MultiStart.h"
+
+/**< STD headers >**/
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+static constexpr double INF = numeric_limits<double>::infinity();
+
+MultiStart::MultiStart(const vector<Vertex*>& _vertices, const Metric* _metric)
+    : n(static_cast<int>(_vertices.size())), vertices(_vertices), metric(_metric) {
+    unordered_map<const Vertex*, int> index;
+    for (int i = 0; i < n; i++) {
+        index[vertices[i]] = i;
+    }
+
+    offsets.assign(n + 1, 0);
+    for (int i = 0; i < n; i++) {
+        for (const Edge* e : vertices[i]->getAdj()) {
+            auto it = index.find(e->getDestination());
+            if (it != index.end() && it->second != i) {
+                targets.push_back(it->second);
+                weights.push_back(e->getDistance());
+            }
+        }
+        offsets[i + 1] = static_cast<int>(targets.size());
+    }
+
+    // Lookup copy: by destination, the cheapest of repeated edges first
+    sorted.resize(targets.size());
+    for (size_t e = 0; e < targets.size(); e++) {
+        sorted[e] = {targets[e], weights[e]};
+    }
+    for (int i = 0; i < n; i++) {
+        sort(sorted.begin() + offsets[i], sorted.begin() + offsets[i + 1]);
+    }
+
+    vector<Point> points(n, Point{0, 0, 0});
+    bool has_points = metric != nullptr;
+    for (int i = 0; i < n && has_points; i++) {
+        has_points = metric->getPoint(vertices[i], points[i].data());
+    }
+    if (has_points) {
+        tree = make_unique<KdTree>(std::move(points));
+    }
+}
+
+void MultiStart::setTree(const vector<int>& parent) {
+    tree_offsets.assign(n + 1, 0);
+    for (int i = 0; i < n; i++) {
+        if (parent[i] != -1) {
+            tree_offsets[i + 1]++;
+            tree_offsets[parent[i] + 1]++;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        tree_offsets[i + 1] += tree_offsets[i];
+    }
+    tree_neighbours.resize(tree_offsets[n]);
+    vector<int> fill = tree_offsets;
+    for (int i = 0; i < n; i++) {
+        if (parent[i] != -1) {
+            tree_neighbours[fill[i]++] = parent[i];
+            tree_neighbours[fill[parent[i]]++] = i;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        sort(tree_neighbours.begin() + tree_offsets[i], tree_neighbours.begin() + tree_offsets[i + 1]);
+    }
+}
+
+MultiStart::Scratch MultiStart::makeScratch() const {
+    Scratch scratch;
+    scratch.visited.assign(n, false);
+    if (tree != nullptr) {
+        scratch.tree = make_unique<KdTree>(*tree);
+    }
+    return scratch;
+}
+
+double MultiStart::edgeDistance(int i, int j) const {
+    auto first = sorted.begin() + offsets[i];
+    auto last = sorted.begin() + offsets[i + 1];
+    auto it = lower_bound(first, last, make_pair(j, -INF));
+    return (it != last && it->first == j) ? it->second : INF;
+}
+
+double MultiStart::distance(int i, int j) const {
+    double d = edgeDistance(i, j);
+    if (d == INF && metric != nullptr && metric->canMeasure(vertices[i], vertices[j])) {
+        d = metric->distance(vertices[i], vertices[j]);
+    }
+    return d;
+}
+
+double MultiStart::nearestNeighbor(int start, bool use_metric, Scratch& scratch, vector<int>& order) const {
+    vector<char>& visited = scratch.visited;
+    fill(visited.begin(), visited.end(), false);
+    order.clear();
+    KdTree* left = (use_metric && scratch.tree != nullptr) ? scratch.tree.get() : nullptr;
+    if (left != nullptr) {
+        left->reset();
+    }
+    auto visit = [&](int v) {
+        visited[v] = true;
+        order.push_back(v);
+        if (left != nullptr) {
+            left->remove(v);
+        }
+    };
+
+    double cost = 0;
+    int current = start;
+    visit(current);
+    while (static_cast<int>(order.size()) < n) {
+        int next = -1;
+        double best = INF;
+        for (int e = offsets[current]; e < offsets[current + 1]; e++) {
+            if (!visited[targets[e]] && (next == -1 || weights[e] < best)) {
+                next = targets[e];
+                best = weights[e];
+            }
+        }
+        if (next == -1 && use_metric) {
+            if (left != nullptr) {
+                next = left->nearestLeft(current);
+                if (next != -1) {
+                    best = metric->distance(vertices[current], vertices[next]);
+                }
+            }
+            else if (metric != nullptr) {
+                for (int v = 0; v < n; v++) {
+                    if (!visited[v] && metric->canMeasure(vertices[current], vertices[v])) {
+                        double d = metric->distance(vertices[current], vertices[v]);
+                        if (d < best) {
+                            best = d;
+                            next = v;
+                        }
+                    }
+                }
+            }
+        }
+        if (next == -1) {
+            return INF;
+        }
+        cost += best;
+        current = next;
+        visit(current);
+    }
+
+    double back = use_metric ? distance(current, start) : edgeDistance(current, start);
+    return (back == INF) ? INF : cost + back;
+}
+
+double MultiStart::treeWalk(int start, Scratch& scratch, vector<int>& order) const {
+    vector<char>& visited = scratch.visited;
+    vector<int>& stack = scratch.stack;
+    fill(visited.begin(), visited.end(), false);
+    order.clear();
+    stack.assign(1, start);
+    visited[start] = true;
+    double cost = 0;
+    while (!stack.empty()) {
+        int v = stack.back();
+        stack.pop_back();
+        if (!order.empty()) {
+            double d = distance(order.back(), v);
+            if (d == INF) {
+                return INF;
+            }
+            cost += d;
+        }
+        order.push_back(v);
+        // Pushed backwards so that the neighbours are visited in index order
+        for (int e = tree_offsets[v + 1] - 1; e >= tree_offsets[v]; e--) {
+            int w = tree_neighbours[e];
+            if (!visited[w]) {
+                visited[w] = true;
+                stack.push_back(w);
+            }
+        }
+    }
+    if (static_cast<int>(order.size()) != n) {
+        return INF;
+    }
+    double back = distance(order.back(), start);
+    return (back == INF) ? INF : cost + back;
+}
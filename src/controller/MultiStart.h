@@ -0,0 +1,107 @@
+#ifndef TSP_ANALYSIS_MULTISTART_H
+#define TSP_ANALYSIS_MULTISTART_H
+
+/**
+ * @file MultiStart.h
+ * @brief Header for the read-only graph copy used to run a construction from many start vertices in parallel
+ */
+
+/**< Project headers >**/
+#include "KdTree.h"
+#include "../model/Graph.h"
+
+/**< STD headers >**/
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class MultiStart
+ * @brief Index view of a graph for the construction heuristics that depend on their start vertex.
+ *
+ * The edges are copied into arrays when it is built and the graph is never read or changed again. Every run keeps its
+ * state in a Scratch of its own (Vertex::visited is not used), so runs from many threads don't interfere.
+ */
+class MultiStart {
+public:
+    /**
+     * @struct Scratch
+     * @brief State of one run, reused by the runs of a thread
+     */
+    struct Scratch {
+        vector<char> visited;
+        vector<int> stack;
+        unique_ptr<KdTree> tree; /**< Vertices not visited yet, null without coordinates >**/
+    };
+
+    /**
+     * @constructor MultiStart
+     * @Complexity - O(V log V + E log E)
+     * @param vertices - vertices, indexed by position
+     * @param metric - metric of the graph, may be null
+     */
+    MultiStart(const vector<Vertex*>& vertices, const Metric* metric);
+
+    /**
+     * @brief Spanning tree walked by treeWalk
+     * @param parent - parent of every vertex, -1 for the root
+     */
+    void setTree(const vector<int>& parent);
+
+    /**
+     * @brief New scratch for the runs of one thread
+     * @return scratch
+     */
+    [[nodiscard]] Scratch makeScratch() const;
+
+    /**
+     * @brief Nearest neighbour from start: the cheapest edge to a vertex not visited is followed, when there is none
+     * the closest vertex by the metric (same rule as Coder::nearestNeighbor) or, without the metric, the run fails
+     * (same rule as Coder::realWorld)
+     * @Complexity - O(E + V log V) with coordinates, O(V^2) without
+     * @param start - start vertex
+     * @param use_metric - fall back to the metric
+     * @param scratch - state of the run
+     * @param order - output, vertices in visiting order
+     * @return tour cost, closing edge included, infinity if the run fails
+     */
+    double nearestNeighbor(int start, bool use_metric, Scratch& scratch, vector<int>& order) const;
+
+    /**
+     * @brief Pre-order walk of the spanning tree rooted at start, the tour of the triangular approximation
+     * @Complexity - O(V log deg)
+     * @param start - root
+     * @param scratch - state of the run
+     * @param order - output, vertices in visiting order
+     * @return tour cost, infinity if a step can't be measured
+     */
+    double treeWalk(int start, Scratch& scratch, vector<int>& order) const;
+
+private:
+    /**
+     * @brief Distance of the cheapest edge i -> j
+     * @Complexity - O(log deg)
+     * @return distance, infinity if there is no edge
+     */
+    [[nodiscard]] double edgeDistance(int i, int j) const;
+
+    /**
+     * @brief Distance of the cheapest edge i -> j, else the metric distance
+     * @return distance, infinity if there is no edge and the metric can't measure it
+     */
+    [[nodiscard]] double distance(int i, int j) const;
+
+    int n; /**< Number of vertices >**/
+    vector<Vertex*> vertices; /**< Vertex of every index, only handed to the metric >**/
+    const Metric* metric; /**< Metric, may be null >**/
+    vector<int> offsets; /**< Edges of i are [offsets[i], offsets[i + 1]) >**/
+    vector<int> targets; /**< Destination of every edge, in the order of the graph >**/
+    vector<double> weights; /**< Distance of every edge, in the order of the graph >**/
+    vector<pair<int, double>> sorted; /**< Edges of every vertex sorted by destination, for the lookups >**/
+    vector<int> tree_offsets; /**< Tree neighbours of i are [tree_offsets[i], tree_offsets[i + 1]) >**/
+    vector<int> tree_neighbours; /**< Tree neighbours, by index >**/
+    unique_ptr<KdTree> tree; /**< Every point, null without coordinates >**/
+};
+
+#endif //TSP_ANALYSIS_MULTISTART_H
@@ -5,9 +5,9 @@
 
 /**< Project headers >**/
 #include "Parser.h"
+#include "DecompressStream.h"
 #include "../Exceptions/CustomError.h"
 /**< STD headers >**/
-#include <fstream>
 #include <sstream>
 
 
@@ -19,61 +19,40 @@ void Parser::setNewGraph(Graph* _graph){
 }
 // Import files main function
 void Parser::importFiles(const string &vertices_path, int number_of_vertices, const string &edges_path, bool symmetric_or_real) {
-    try {
-        // Build graph
-        if (edges_path.empty()) {
-            importVerticesWithEdges(vertices_path, symmetric_or_real);
-        }
-        else {
-            importVertices(vertices_path, number_of_vertices);
-            importEdges(edges_path, symmetric_or_real);
-        }
+    // Build graph
+    if (edges_path.empty()) {
+        importVerticesWithEdges(vertices_path, symmetric_or_real);
     }
-    catch (const CustomError &e){
-        cerr << e.what() << endl;
-        exit(EXIT_FAILURE);
+    else {
+        importVertices(vertices_path, number_of_vertices);
+        importEdges(edges_path, symmetric_or_real);
     }
 }
 
-// Program that checks if the first line of a file is to discard
-bool isFirstLineToDiscard(const string& file_path){
-    // Open file
-    fstream fin;
-    fin.open(file_path);
-    if (!fin.is_open()){
-        throw CustomError("Error opening file",FILE_ERROR);
-    }
-    // Process file
-    string line;
+// Program that checks if a line is a header line (first field is not a number)
+bool isHeaderLine(const string& line){
     string word;
-    getline(fin,line);
     stringstream ss(line);
     if (getline(ss, word, ',')) {
         try {
             stoi(word);
-            fin.close();
             return false;
         } catch (const invalid_argument& e) {
-            fin.close();
             return true;
         } catch (const out_of_range& e) {
-            fin.close();
             return true;
         }
     }
-    // Close file
-    fin.close();
     return true;
 }
 
 // Import only vertices
 void Parser::importVertices(const string &file_path, int number_of_vertices){
     // Open file
-    fstream fin;
-    fin.open(file_path,ios::in);
+    unique_ptr<istream> fin = DecompressStream::open(file_path);
     int count = number_of_vertices;
 
-    if (!fin.is_open()){
+    if (fin == nullptr){
         throw CustomError("Error opening file",FILE_ERROR);
     }
 
@@ -82,15 +61,18 @@ void Parser::importVertices(const string &file_path, int number_of_vertices){
     string line;
     string word;
 
-    bool firstLineToDiscard = isFirstLineToDiscard(file_path);
-    if (firstLineToDiscard){
-        getline(fin,line); // Discard first line
-    }
+    bool first_line = true;
 
-    while(getline(fin,line) && count > 0 ){
+    while(getline(*fin,line) && count > 0 ){
         row.clear();
+        if (first_line){
+            first_line = false;
+            if (isHeaderLine(line)){
+                continue; // Discard first line
+            }
+        }
         // Carriage return
-        if (line.at(line.size()-1) == '\r'){
+        if (!line.empty() && line.at(line.size()-1) == '\r'){
             line = line.substr(0,line.size()-1);
         }
         stringstream ss(line);
@@ -116,16 +98,16 @@ void Parser::importVertices(const string &file_path, int number_of_vertices){
         }
         count--;
     }
-    // Close file
-    fin.close();
+    if (fin->bad()){
+        throw CustomError("Error reading file",FILE_ERROR);
+    }
 }
 
 void Parser::importEdges(const string &file_path, bool symmetric_or_real){
     // Open file
-    fstream fin;
-    fin.open(file_path, ios::in);
+    unique_ptr<istream> fin = DecompressStream::open(file_path);
 
-    if (!fin.is_open()){
+    if (fin == nullptr){
         throw CustomError("Error opening file",FILE_ERROR);
     }
 
@@ -134,15 +116,18 @@ void Parser::importEdges(const string &file_path, bool symmetric_or_real){
     string line;
     string word;
 
-    bool firstLineToDiscard = isFirstLineToDiscard(file_path);
-    if (firstLineToDiscard){
-        getline(fin,line); // Discard first line
-    }
+    bool first_line = true;
 
-    while(getline(fin,line)){
+    while(getline(*fin,line)){
         row.clear();
+        if (first_line){
+            first_line = false;
+            if (isHeaderLine(line)){
+                continue; // Discard first line
+            }
+        }
         // Carriage return
-        if (line.at(line.size()-1) == '\r'){
+        if (!line.empty() && line.at(line.size()-1) == '\r'){
             line = line.substr(0,line.size()-1);
         }
         stringstream ss(line);
@@ -166,16 +151,16 @@ void Parser::importEdges(const string &file_path, bool symmetric_or_real){
             }
         }
     }
-    // Close file
-    fin.close();
+    if (fin->bad()){
+        throw CustomError("Error reading file",FILE_ERROR);
+    }
 }
 
 void Parser::importVerticesWithEdges(const string &file_path, bool symmetric_or_real) {
     // Open file
-    fstream fin;
-    fin.open(file_path,ios::in);
+    unique_ptr<istream> fin = DecompressStream::open(file_path);
 
-    if (!fin.is_open()){
+    if (fin == nullptr){
         throw CustomError("Error opening file",FILE_ERROR);
     }
 
@@ -183,15 +168,18 @@ void Parser::importVerticesWithEdges(const string &file_path, bool symmetric_or_
     vector<string> row;
     string line;
     string word;
-    bool firstLineToDiscard = isFirstLineToDiscard(file_path);
-    if (firstLineToDiscard){
-        getline(fin,line); // Discard first line
-    }
+    bool first_line = true;
 
-    while(getline(fin,line)){
+    while(getline(*fin,line)){
         row.clear();
+        if (first_line){
+            first_line = false;
+            if (isHeaderLine(line)){
+                continue; // Discard first line
+            }
+        }
         // Carriage return
-        if (line.at(line.size()-1) == '\r'){
+        if (!line.empty() && line.at(line.size()-1) == '\r'){
             line = line.substr(0,line.size()-1);
         }
         stringstream ss(line);
@@ -232,8 +220,192 @@ void Parser::importVerticesWithEdges(const string &file_path, bool symmetric_or_
         }
 
     }
-    // Close file
-    fin.close();
+    if (fin->bad()){
+        throw CustomError("Error reading file",FILE_ERROR);
+    }
 
 }
 
+/**
+ * @note TSPLIB import
+ */
+
+// Splits a TSPLIB specification line "KEY : VALUE" (a section line has an empty value)
+void splitTSPLIBLine(const string& line, string& key, string& value){
+    auto trim = [](const string& input) {
+        const auto start = input.find_first_not_of(" \t\r\n");
+        const auto end = input.find_last_not_of(" \t\r\n");
+        return (start != string::npos) ? input.substr(start, end - start + 1) : "";
+    };
+    auto colon = line.find(':');
+    if (colon == string::npos){
+        key = trim(line);
+        value = "";
+    }
+    else {
+        key = trim(line.substr(0, colon));
+        value = trim(line.substr(colon + 1));
+    }
+}
+
+int Parser::readTSPLIBDimension(const string &file_path) {
+    // Open file
+    unique_ptr<istream> fin = DecompressStream::open(file_path);
+    if (fin == nullptr){
+        throw CustomError("Error opening file",FILE_ERROR);
+    }
+
+    // Only the specification part is read
+    string line, key, value;
+    while (getline(*fin, line)){
+        splitTSPLIBLine(line, key, value);
+        if (key == "DIMENSION"){
+            return stoi(value);
+        }
+        if (key.find("_SECTION") != string::npos || key == "EOF"){
+            break;
+        }
+    }
+    throw CustomError("TSPLIB file without DIMENSION", PARSE_ERROR);
+}
+
+vector<double> Parser::readTSPLIBMatrix(istream &fin, const string &format, int dimension) {
+    auto n = static_cast<size_t>(dimension);
+    vector<double> matrix(n * n, 0.0);
+    double weight;
+
+    auto read = [&](size_t i, size_t j) {
+        if (!(fin >> weight)){
+            throw CustomError("EDGE_WEIGHT_SECTION is shorter than expected", PARSE_ERROR);
+        }
+        matrix[i * n + j] = weight;
+        matrix[j * n + i] = weight;
+    };
+
+    if (format == "FULL_MATRIX"){
+        for (size_t i = 0; i < n * n; i++){
+            if (!(fin >> matrix[i])){
+                throw CustomError("EDGE_WEIGHT_SECTION is shorter than expected", PARSE_ERROR);
+            }
+        }
+    }
+    // Column formats of a symmetric matrix are the row formats of the other triangle
+    else if (format == "UPPER_ROW" || format == "LOWER_COL"){
+        for (size_t i = 0; i < n; i++) for (size_t j = i + 1; j < n; j++) read(i, j);
+    }
+    else if (format == "LOWER_ROW" || format == "UPPER_COL"){
+        for (size_t i = 0; i < n; i++) for (size_t j = 0; j < i; j++) read(i, j);
+    }
+    else if (format == "UPPER_DIAG_ROW" || format == "LOWER_DIAG_COL"){
+        for (size_t i = 0; i < n; i++) for (size_t j = i; j < n; j++) read(i, j);
+    }
+    else if (format == "LOWER_DIAG_ROW" || format == "UPPER_DIAG_COL"){
+        for (size_t i = 0; i < n; i++) for (size_t j = 0; j <= i; j++) read(i, j);
+    }
+    else {
+        throw CustomError("Unsupported EDGE_WEIGHT_FORMAT: " + format, PARSE_ERROR);
+    }
+    return matrix;
+}
+
+void Parser::importTSPLIB(const string &file_path) {
+    // Open file
+    unique_ptr<istream> fin = DecompressStream::open(file_path);
+    if (fin == nullptr){
+        throw CustomError("Error opening file",FILE_ERROR);
+    }
+
+    // Specification part
+    string line, key, value;
+    string type = "TSP", weight_type, weight_format = "FULL_MATRIX";
+    int dimension = -1;
+    auto* metric = new Metric(HAVERSINE);
+    graph->setMetric(metric);
+
+    // Vertices of explicit instances have no coordinates
+    auto addVertices = [&]() {
+        for (int id = 1; id <= dimension; id++){
+            string label = to_string(id);
+            auto* v = new Vertex(id - 1, label, nullptr);
+            graph->addVertex(v);
+            vertices_table->insertBucket(id - 1, v);
+        }
+    };
+
+    while (getline(*fin, line)){
+        splitTSPLIBLine(line, key, value);
+        if (key.empty()){
+            continue;
+        }
+        if (key == "TYPE"){
+            type = value;
+            if (type != "TSP" && type != "ATSP"){
+                throw CustomError("Unsupported TSPLIB TYPE: " + type, PARSE_ERROR);
+            }
+        }
+        else if (key == "DIMENSION"){
+            dimension = stoi(value);
+        }
+        else if (key == "EDGE_WEIGHT_TYPE"){
+            weight_type = value;
+            WEIGHT_TYPE wt;
+            if (value == "EUC_2D") wt = EUC_2D;
+            else if (value == "CEIL_2D") wt = CEIL_2D;
+            else if (value == "GEO") wt = GEO;
+            else if (value == "ATT") wt = ATT;
+            else if (value == "EXPLICIT") wt = EXPLICIT;
+            else throw CustomError("Unsupported EDGE_WEIGHT_TYPE: " + value, PARSE_ERROR);
+            metric = new Metric(wt);
+            graph->setMetric(metric);
+        }
+        else if (key == "EDGE_WEIGHT_FORMAT"){
+            weight_format = value;
+        }
+        else if (key == "NODE_COORD_SECTION"){
+            if (dimension <= 0 || weight_type.empty()){
+                throw CustomError("NODE_COORD_SECTION before DIMENSION/EDGE_WEIGHT_TYPE", PARSE_ERROR);
+            }
+            // Stream "id x y" triples, no edges are built
+            int id;
+            double x, y;
+            for (int i = 0; i < dimension; i++){
+                if (!(*fin >> id >> x >> y)){
+                    throw CustomError("NODE_COORD_SECTION is shorter than DIMENSION", PARSE_ERROR);
+                }
+                string label = to_string(id);
+                auto* v = new Vertex(id - 1, label, Coordinate::planar(x, y));
+                graph->addVertex(v);
+                vertices_table->insertBucket(id - 1, v);
+            }
+        }
+        else if (key == "EDGE_WEIGHT_SECTION"){
+            if (dimension <= 0 || metric->getType() != EXPLICIT){
+                throw CustomError("EDGE_WEIGHT_SECTION without DIMENSION or EXPLICIT weights", PARSE_ERROR);
+            }
+            if (type == "ATSP" && weight_format != "FULL_MATRIX"){
+                throw CustomError("ATSP instances need a FULL_MATRIX", PARSE_ERROR);
+            }
+            metric->setExplicitMatrix(readTSPLIBMatrix(*fin, weight_format, dimension), dimension);
+            if (graph->getNumberOfVertexes() == 0){
+                addVertices();
+            }
+        }
+        else if (key == "DISPLAY_DATA_SECTION"){
+            // Display coordinates are not used for distances
+            double skip;
+            for (int i = 0; i < 3 * dimension && *fin >> skip; i++);
+        }
+        else if (key == "EOF"){
+            break;
+        }
+        else if (key.find("_SECTION") != string::npos){
+            throw CustomError("Unsupported TSPLIB section: " + key, PARSE_ERROR);
+        }
+    }
+    if (fin->bad()){
+        throw CustomError("Error reading file",FILE_ERROR);
+    }
+    if (graph->getNumberOfVertexes() != dimension){
+        throw CustomError("TSPLIB file has a different number of nodes than DIMENSION", PARSE_ERROR);
+    }
+}
@@ -30,6 +30,9 @@ public:
 
     /**
      * @brief This method is a interface function that builds a Graph from a file
+     * @note Files ending in .gz/.zst (or missing files with a .gz/.zst sibling) are decompressed on a worker thread
+     * while they are parsed, see DecompressStream.
+     * @note Throws CustomError if a file can't be opened or read, the graph is then incomplete
      * @param vertices_path -> Vertices file path
      * @param edges_path -> Edges file path
      * @param number_of_vertices -> number of vertices to process
@@ -37,6 +40,26 @@ public:
      */
     void importFiles(const string& vertices_path, int number_of_vertices, const string& edges_path, bool symmetric_or_real);
 
+    /**
+     * @brief Reads only the header of a TSPLIB file to get the number of vertices
+     * @note Used to size the vertices table before the import
+     * @param file_path -> TSPLIB (.tsp/.atsp) file path
+     * @return DIMENSION of the instance
+     */
+    static int readTSPLIBDimension(const string& file_path);
+
+    /**
+     * @brief Builds a Graph from a TSPLIB file in one streaming pass
+     *
+     * Supported EDGE_WEIGHT_TYPE: EUC_2D, CEIL_2D, GEO, ATT and EXPLICIT (FULL_MATRIX, UPPER/LOWER_ROW, UPPER/LOWER_DIAG_ROW
+     * and the column variants). No edges are created, the distances are given on demand by the graph metric.
+     * Node ids are stored 0-based (TSPLIB id - 1), the label keeps the TSPLIB id.
+     *
+     * @note Throws CustomError if the file can't be read or is not supported, the graph is then incomplete
+     * @param file_path -> TSPLIB (.tsp/.atsp) file path
+     */
+    void importTSPLIB(const string& file_path);
+
 private:
     /**
      * @brief Import vertices
@@ -61,6 +84,15 @@ private:
      */
     void importVerticesWithEdges(const string& file_path, bool symmetric_or_real);
 
+    /**
+     * @brief Reads the EDGE_WEIGHT_SECTION of a TSPLIB file into a full matrix
+     * @param fin - stream positioned after the section keyword
+     * @param format - EDGE_WEIGHT_FORMAT
+     * @param dimension - number of vertices
+     * @return row major dimension * dimension matrix
+     */
+    static vector<double> readTSPLIBMatrix(istream& fin, const string& format, int dimension);
+
     Graph* graph = nullptr; /**< Pointer to graph >**/
     HashTable* vertices_table = nullptr; /**< Pointer to table >**/
 
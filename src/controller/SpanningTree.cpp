@@ -0,0 +1,145 @@
+/**
+ * @file SpanningTree.cpp
+ * @brief Implementation of the parallel minimum spanning forest
+ */
+
+/**< Project headers >**/
+#include "SpanningTree.h"
+#include "ThreadPool.h"
+
+/**< STD headers >**/
+#include <atomic>
+#include <memory>
+
+namespace {
+
+/**
+ * @class DisjointSets
+ * @brief Union-find safe to use from many threads without locks: find halves the paths with compare-and-swap and
+ * unite links the larger root under the smaller one, so no cycle can be made by concurrent unions.
+ */
+class DisjointSets {
+public:
+    explicit DisjointSets(int n) : parent(make_unique<atomic<int>[]>(n)) {
+        for (int i = 0; i < n; i++) {
+            parent[i].store(i, memory_order_relaxed);
+        }
+    }
+
+    int find(int x) {
+        while (true) {
+            int p = parent[x].load(memory_order_relaxed);
+            if (p == x) {
+                return x;
+            }
+            int grandparent = parent[p].load(memory_order_relaxed);
+            if (p != grandparent) {
+                parent[x].compare_exchange_weak(p, grandparent, memory_order_relaxed);
+            }
+            x = grandparent;
+        }
+    }
+
+    /**
+     * @return false if a and b were already in the same set
+     */
+    bool unite(int a, int b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) {
+                return false;
+            }
+            if (a > b) {
+                swap(a, b);
+            }
+            int expected = b;
+            if (parent[b].compare_exchange_strong(expected, a, memory_order_acq_rel)) {
+                return true;
+            }
+        }
+    }
+
+private:
+    unique_ptr<atomic<int>[]> parent; /**< Parent of each element, roots point to themselves >**/
+};
+
+}
+
+vector<int> SpanningTree::boruvka(int n, const vector<TreeEdge>& edges, int threads) {
+    auto cheaper = [&edges](int a, int b) {
+        return edges[a].distance < edges[b].distance || (edges[a].distance == edges[b].distance && a < b);
+    };
+
+    ThreadPool pool(threads);
+    DisjointSets sets(n);
+    auto cheapest = make_unique<atomic<int>[]>(n);
+    vector<char> in_forest(edges.size(), false);
+    vector<int> live;
+    live.reserve(edges.size());
+    for (int i = 0; i < static_cast<int>(edges.size()); i++) {
+        if (edges[i].u != edges[i].v) {
+            live.push_back(i);
+        }
+    }
+
+    while (!live.empty()) {
+        for (int i = 0; i < n; i++) {
+            cheapest[i].store(-1, memory_order_relaxed);
+        }
+
+        // Cheapest edge leaving every component (no union happens in this phase)
+        pool.parallelFor(0, live.size(), GRAIN, [&](size_t begin, size_t end, int) {
+            for (size_t i = begin; i < end; i++) {
+                int e = live[i];
+                int roots[2] = {sets.find(edges[e].u), sets.find(edges[e].v)};
+                if (roots[0] == roots[1]) {
+                    continue;
+                }
+                for (int root : roots) {
+                    int current = cheapest[root].load(memory_order_relaxed);
+                    while ((current == -1 || cheaper(e, current)) &&
+                           !cheapest[root].compare_exchange_weak(current, e, memory_order_relaxed)) {}
+                }
+            }
+        });
+
+        // Merge along the chosen edges, an edge chosen by both of its components is added once
+        atomic<bool> merged{false};
+        pool.parallelFor(0, n, GRAIN, [&](size_t begin, size_t end, int) {
+            for (size_t root = begin; root < end; root++) {
+                int e = cheapest[root].load(memory_order_relaxed);
+                if (e != -1 && sets.unite(edges[e].u, edges[e].v)) {
+                    in_forest[e] = true;
+                    merged.store(true, memory_order_relaxed);
+                }
+            }
+        });
+        if (!merged.load()) {
+            break;
+        }
+
+        // Drop the edges that ended inside a component
+        vector<vector<int>> kept(pool.getThreads());
+        pool.parallelFor(0, live.size(), GRAIN, [&](size_t begin, size_t end, int thread) {
+            for (size_t i = begin; i < end; i++) {
+                int e = live[i];
+                if (sets.find(edges[e].u) != sets.find(edges[e].v)) {
+                    kept[thread].push_back(e);
+                }
+            }
+        });
+        live.clear();
+        for (const vector<int>& part : kept) {
+            live.insert(live.end(), part.begin(), part.end());
+        }
+    }
+
+    vector<int> forest;
+    for (int i = 0; i < static_cast<int>(edges.size()); i++) {
+        if (in_forest[i]) {
+            forest.push_back(i);
+        }
+    }
+    return forest;
+}
@@ -0,0 +1,48 @@
+#ifndef TSP_ANALYSIS_SPANNINGTREE_H
+#define TSP_ANALYSIS_SPANNINGTREE_H
+
+/**
+ * @file SpanningTree.h
+ * @brief Header for the parallel minimum spanning forest over an edge array
+ */
+
+/**< STD headers >**/
+#include <vector>
+
+using namespace std;
+
+/**
+ * @struct TreeEdge
+ * @brief Undirected edge u - v (vertex indices)
+ */
+struct TreeEdge {
+    int u;
+    int v;
+    double distance;
+};
+
+/**
+ * @class SpanningTree
+ * @brief Minimum spanning forests of graphs given as an array of undirected edges.
+ *
+ * Edges are compared by (distance, position in the array), a total order, so the forest is unique and the same for any
+ * number of threads. When the distances are distinct it is the tree every MST algorithm finds (prim included).
+ */
+class SpanningTree {
+public:
+    /**
+     * @brief Parallel Borůvka: every round each component takes its cheapest outgoing edge, the components are merged
+     * with a lock-free union-find and the edges inside a component are dropped
+     * @Complexity - O(E log V / threads) time, O(V + E) memory
+     * @param n - number of vertices
+     * @param edges - undirected edges
+     * @param threads - number of threads, 0 uses the hardware concurrency
+     * @return positions in edges of the forest edges, in increasing order
+     */
+    static vector<int> boruvka(int n, const vector<TreeEdge>& edges, int threads = 0);
+
+private:
+    static constexpr size_t GRAIN = 4096; /**< Edges / vertices per parallel chunk >**/
+};
+
+#endif //TSP_ANALYSIS_SPANNINGTREE_H
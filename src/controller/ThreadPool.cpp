@@ -0,0 +1,55 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief Implementation of the thread pool
+ */
+
+/**< Project headers >**/
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threads) {
+    int n = resolveThreads(threads);
+    size = n;
+    // The thread that calls parallelFor also works, so n - 1 workers are enough for it,
+    // but submitted tasks need at least one worker
+    for (int i = 0; i < max(n - 1, 1); i++) {
+        workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    available.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::getThreads() const {
+    return size;
+}
+
+int ThreadPool::resolveThreads(int threads) {
+    if (threads <= 0) {
+        threads = static_cast<int>(thread::hardware_concurrency());
+    }
+    return max(threads, 1);
+}
+
+void ThreadPool::work() {
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<mutex> guard(lock);
+            available.wait(guard, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,132 @@
+#ifndef TSP_ANALYSIS_THREADPOOL_H
+#define TSP_ANALYSIS_THREADPOOL_H
+
+/**
+ * @file ThreadPool.h
+ * @brief Header for the thread pool used by the parallel algorithms
+ */
+
+/**< STD headers >**/
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class ThreadPool
+ * @brief Fixed number of worker threads that run queued tasks.
+ */
+class ThreadPool {
+public:
+    /**
+     * @constructor ThreadPool
+     * @param threads - number of threads, 0 uses the hardware concurrency
+     */
+    explicit ThreadPool(int threads = 0);
+
+    /**
+     * @destructor ThreadPool - finishes the queued tasks and joins the threads
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Number of threads of the pool
+     * @return threads
+     */
+    [[nodiscard]] int getThreads() const;
+
+    /**
+     * @brief Number of threads for a request (0 -> hardware concurrency, at least 1)
+     * @param threads - requested threads
+     * @return threads
+     */
+    static int resolveThreads(int threads);
+
+    /**
+     * @brief Queue a task
+     * @param task - callable without arguments
+     * @return future with the result of the task
+     */
+    template<typename F>
+    auto submit(F&& task) -> future<decltype(task())>;
+
+    /**
+     * @brief Runs body(chunk_begin, chunk_end, thread) over [begin, end) split in chunks of grain iterations.
+     * @note Blocks until every chunk is done, the calling thread works too. Chunks are claimed in order.
+     * @param begin - first iteration
+     * @param end - one past the last iteration
+     * @param grain - iterations per chunk
+     * @param body - callable (size_t, size_t, int)
+     */
+    template<typename F>
+    void parallelFor(size_t begin, size_t end, size_t grain, F&& body);
+
+private:
+    /**
+     * @brief Worker thread body
+     */
+    void work();
+
+    int size; /**< Threads working in parallelFor (workers + caller) >**/
+    vector<thread> workers; /**< Worker threads >**/
+    deque<function<void()>> tasks; /**< Queued tasks >**/
+    mutex lock; /**< Protects tasks and stopping >**/
+    condition_variable available; /**< Signals new tasks >**/
+    bool stopping = false; /**< Pool is being destroyed >**/
+};
+
+template<typename F>
+auto ThreadPool::submit(F&& task) -> future<decltype(task())> {
+    using R = decltype(task());
+    auto packaged = make_shared<packaged_task<R()>>(std::forward<F>(task));
+    future<R> result = packaged->get_future();
+    {
+        lock_guard<mutex> guard(lock);
+        tasks.emplace_back([packaged]() { (*packaged)(); });
+    }
+    available.notify_one();
+    return result;
+}
+
+template<typename F>
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain, F&& body) {
+    if (begin >= end) {
+        return;
+    }
+    if (grain == 0) {
+        grain = 1;
+    }
+    size_t chunks = (end - begin + grain - 1) / grain;
+    auto helpers = static_cast<size_t>(getThreads());
+    helpers = min(helpers, chunks) - 1;
+
+    atomic<size_t> next{0};
+    auto run = [&, begin, end, grain](int thread) {
+        for (size_t chunk = next.fetch_add(1); chunk < chunks; chunk = next.fetch_add(1)) {
+            size_t chunk_begin = begin + chunk * grain;
+            body(chunk_begin, min(end, chunk_begin + grain), thread);
+        }
+    };
+
+    vector<future<void>> running;
+    running.reserve(helpers);
+    for (size_t i = 0; i < helpers; i++) {
+        running.push_back(submit([&run, i]() { run(static_cast<int>(i) + 1); }));
+    }
+    run(0);
+    for (auto& f : running) {
+        f.get();
+    }
+}
+
+#endif //TSP_ANALYSIS_THREADPOOL_H
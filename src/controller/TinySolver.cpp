@@ -0,0 +1,128 @@
+/**
+ * @file TinySolver.cpp
+ * @brief Implementation of the exact solvers specialized by size
+ */
+
+/**< Project headers >**/
+#include "TinySolver.h"
+
+/**< STD headers >**/
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+static constexpr double INF = numeric_limits<double>::infinity();
+static constexpr size_t STACK_TABLE = 1 << 18; /**< Bytes of DP table allowed on the stack >**/
+
+/**
+ * @brief Held-Karp over the subsets of 1..N-1, entry (mask, j) is the cheapest path from 0 through mask ending at j + 1
+ * @note Subsets are solved in increasing order, mask without j is always smaller than mask
+ */
+template<int N>
+static double fillTable(const array<double, N * N>& w, double* cost, uint8_t* parent, int* order) {
+    constexpr int M = N - 1;
+    constexpr uint32_t FULL = (uint32_t(1) << M) - 1;
+
+    for (int j = 0; j < M; j++) {
+        cost[(size_t(1) << j) * M + j] = w[j + 1];
+    }
+    for (uint32_t mask = 3; mask <= FULL; mask++) {
+        if ((mask & (mask - 1)) == 0) {
+            continue;
+        }
+        double* row = cost + size_t(mask) * M;
+        // Only the vertices of the subsets are visited (lowest bit first)
+        for (uint32_t bits = mask; bits != 0; bits &= bits - 1) {
+            int j = __builtin_ctz(bits);
+            uint32_t previous = mask ^ (uint32_t(1) << j);
+            const double* previous_row = cost + size_t(previous) * M;
+            const double* to_j = w.data() + N + j + 1;
+            double best = INF;
+            int best_k = 0;
+            for (uint32_t others = previous; others != 0; others &= others - 1) {
+                int k = __builtin_ctz(others);
+                double c = previous_row[k] + to_j[k * N];
+                if (c < best) {
+                    best = c;
+                    best_k = k;
+                }
+            }
+            row[j] = best;
+            parent[size_t(mask) * M + j] = static_cast<uint8_t>(best_k);
+        }
+    }
+
+    double best = INF;
+    int last = 0;
+    for (int j = 0; j < M; j++) {
+        double c = cost[size_t(FULL) * M + j] + w[(j + 1) * N];
+        if (c < best) {
+            best = c;
+            last = j;
+        }
+    }
+    if (best == INF) {
+        return INF;
+    }
+
+    order[0] = 0;
+    uint32_t mask = FULL;
+    for (int position = M; position >= 1; position--) {
+        order[position] = last + 1;
+        int previous = parent[size_t(mask) * M + last];
+        mask ^= uint32_t(1) << last;
+        last = previous;
+    }
+    return best;
+}
+
+template<int N>
+static double solveFixed(const double* distances, int* order) {
+    if constexpr (N == 1) {
+        order[0] = 0;
+        return 0;
+    }
+    else {
+        constexpr int M = N - 1;
+        constexpr size_t ENTRIES = (size_t(1) << M) * M;
+
+        array<double, N * N> w;
+        for (int i = 0; i < N * N; i++) {
+            w[i] = distances[i];
+        }
+
+        if constexpr (ENTRIES * (sizeof(double) + sizeof(uint8_t)) <= STACK_TABLE) {
+            array<double, ENTRIES> cost;
+            array<uint8_t, ENTRIES> parent;
+            return fillTable<N>(w, cost.data(), parent.data(), order);
+        }
+        else {
+            thread_local vector<double> cost;
+            thread_local vector<uint8_t> parent;
+            if (cost.size() < ENTRIES) {
+                cost.resize(ENTRIES);
+                parent.resize(ENTRIES);
+            }
+            return fillTable<N>(w, cost.data(), parent.data(), order);
+        }
+    }
+}
+
+typedef double (*FixedSolver)(const double*, int*);
+
+template<size_t... I>
+static constexpr array<FixedSolver, sizeof...(I)> makeSolvers(index_sequence<I...>) {
+    return {{&solveFixed<static_cast<int>(I) + 1>...}};
+}
+
+double TinySolver::solve(const double* distances, int n, int* order) {
+    static constexpr array<FixedSolver, MAX_SIZE> solvers = makeSolvers(make_index_sequence<MAX_SIZE>{});
+    if (n < 1 || n > MAX_SIZE) {
+        return INF;
+    }
+    return solvers[n - 1](distances, order);
+}
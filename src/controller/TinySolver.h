@@ -0,0 +1,36 @@
+#ifndef TSP_ANALYSIS_TINYSOLVER_H
+#define TSP_ANALYSIS_TINYSOLVER_H
+
+/**
+ * @file TinySolver.h
+ * @brief Header for the exact solvers specialized by size for tiny instances
+ */
+
+/**< STD headers >**/
+#include <cstddef>
+
+/**
+ * @class TinySolver
+ * @brief Exact solvers for instances up to MAX_SIZE vertices, one template instance per size.
+ *
+ * Each size has its own Held-Karp with the size known at compile time, so the distances are copied to a stack array
+ * and every stride and loop bound is a constant the compiler can unroll with. The tables live on the stack for the small
+ * sizes and in a per-thread buffer reused between calls for the bigger ones, so no allocation happens per query. Works
+ * on raw row-major matrices, without a graph, so that many small queries can be answered in a row.
+ */
+class TinySolver {
+public:
+    static constexpr int MAX_SIZE = 16; /**< Biggest size with a specialized solver >**/
+
+    /**
+     * @brief Solves an instance exactly with the solver of its size
+     * @Complexity - O(n^2 * 2^n) time
+     * @param distances - n * n row-major distances (infinity if there is no edge), index 0 is the start
+     * @param n - number of vertices (1 to MAX_SIZE)
+     * @param order - n indices in visiting order, starting at 0 (untouched if there is no tour)
+     * @return tour cost, infinity if there is no tour or n is out of range
+     */
+    static double solve(const double* distances, int n, int* order);
+};
+
+#endif //TSP_ANALYSIS_TINYSOLVER_H
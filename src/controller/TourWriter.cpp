@@ -0,0 +1,132 @@
+/**
+ * @file TourWriter.cpp
+ * @brief Implementation of the tour writer
+ */
+
+/**< Project headers >**/
+#include "TourWriter.h"
+#include "../Exceptions/CustomError.h"
+/**< STD headers >**/
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+vector<int> TourWriter::getVertexOrder(const Result& result) {
+    vector<int> order;
+    order.reserve(result.tour.size());
+    for (const Edge* e : result.tour){
+        if (e == nullptr){
+            throw CustomError("NullPtr: edge e is null ptr", ERROR);
+        }
+        order.push_back(e->getOrigin()->getId());
+    }
+    return order;
+}
+
+/**
+ * @note Formatting buffer, written to the stream when full
+ */
+class TourBuffer {
+public:
+    TourBuffer(ostream& _out, size_t capacity) : out(_out) {
+        buffer.reserve(capacity);
+    }
+
+    ~TourBuffer() {
+        flush();
+    }
+
+    void append(const char* data, size_t size) {
+        if (buffer.size() + size > buffer.capacity()) {
+            flush();
+        }
+        buffer.insert(buffer.end(), data, data + size);
+    }
+
+    void append(const string& text) {
+        append(text.data(), text.size());
+    }
+
+    void appendNumber(long long number) {
+        char digits[24];
+        auto result = to_chars(digits, digits + sizeof(digits), number);
+        append(digits, static_cast<size_t>(result.ptr - digits));
+    }
+
+    template<typename T>
+    void appendRaw(const T& value) {
+        char bytes[sizeof(T)];
+        memcpy(bytes, &value, sizeof(T));
+        append(bytes, sizeof(T));
+    }
+
+    void flush() {
+        if (!buffer.empty()) {
+            out.write(buffer.data(), static_cast<streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+
+private:
+    ostream& out;
+    vector<char> buffer;
+};
+
+void TourWriter::writeTour(ostream& out, TOUR_FORMAT format, const string& name, const vector<int>& order, double distance) {
+    {
+        TourBuffer buffer(out, BUFFER_SIZE);
+        switch (format) {
+            case CSV_ORDER:
+                buffer.append("position,id\n");
+                for (size_t i = 0; i < order.size(); i++){
+                    buffer.appendNumber(static_cast<long long>(i));
+                    buffer.append(",", 1);
+                    buffer.appendNumber(order[i]);
+                    buffer.append("\n", 1);
+                }
+                break;
+            case TSPLIB_TOUR:
+                buffer.append("NAME : " + name + "\n");
+                buffer.append("COMMENT : Length " + to_string(distance) + "\n");
+                buffer.append("TYPE : TOUR\n");
+                buffer.append("DIMENSION : " + to_string(order.size()) + "\n");
+                buffer.append("TOUR_SECTION\n");
+                for (int id : order){
+                    buffer.appendNumber(id + 1);
+                    buffer.append("\n", 1);
+                }
+                buffer.append("-1\nEOF\n");
+                break;
+            case BINARY:
+                buffer.append("TSPT", 4);
+                buffer.appendRaw<uint32_t>(1);
+                buffer.appendRaw<uint32_t>(static_cast<uint32_t>(order.size()));
+                buffer.appendRaw<double>(distance);
+                for (int id : order){
+                    buffer.appendRaw<uint32_t>(static_cast<uint32_t>(id));
+                }
+                break;
+            default:
+                throw CustomError("Unknown tour format", ERROR);
+        }
+    }
+    out.flush();
+    if (!out.good()){
+        throw CustomError("Error writing tour", FILE_ERROR);
+    }
+}
+
+void TourWriter::writeTour(const string& file_path, TOUR_FORMAT format, const string& name, const vector<int>& order, double distance) {
+    if (file_path == "-"){
+        writeTour(cout, format, name, order, distance);
+        return;
+    }
+    ofstream fout(file_path, ios::out | ios::trunc | ios::binary);
+    if (!fout.is_open()){
+        throw CustomError("Error opening file", FILE_ERROR);
+    }
+    writeTour(fout, format, name, order, distance);
+    fout.close();
+}
@@ -0,0 +1,63 @@
+#ifndef TSP_ANALYSIS_TOURWRITER_H
+#define TSP_ANALYSIS_TOURWRITER_H
+
+/**
+ * @file TourWriter.h
+ * @brief Header for the tour writer
+ */
+
+/**< Project headers >**/
+#include "Coder.h"
+/**< STD headers >**/
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Export formats of a tour
+ */
+enum TOUR_FORMAT{
+    CSV_ORDER,   /**< "position,id" lines in visiting order >**/
+    TSPLIB_TOUR, /**< TSPLIB .tour (1-based ids, TOUR_SECTION terminated by -1) >**/
+    BINARY       /**< "TSPT" magic, uint32 version, uint32 n, double distance, n uint32 ids (native endianness) >**/
+};
+
+/**
+ * @class TourWriter - Exports tours so they can be compared with other solvers and published optimal tours
+ * @note Output is formatted into a large buffer and written in big blocks, never flushed per vertex.
+ */
+class TourWriter {
+public:
+    /**
+     * @brief Vertex order of a tour (origin of every edge), as 0-based vertex ids
+     * @param result - result of an algorithm
+     * @return vertex ids in visiting order, empty if no solution
+     */
+    static vector<int> getVertexOrder(const Result& result);
+
+    /**
+     * @brief Write a tour to a stream
+     * @param out - output stream (opened in binary mode for BINARY)
+     * @param format - export format
+     * @param name - name of the tour (TSPLIB NAME)
+     * @param order - 0-based vertex ids in visiting order
+     * @param distance - tour cost
+     */
+    static void writeTour(ostream& out, TOUR_FORMAT format, const string& name, const vector<int>& order, double distance);
+
+    /**
+     * @brief Write a tour to a file, or to stdout if file_path is "-"
+     * @param file_path - output path
+     * @param format - export format
+     * @param name - name of the tour (TSPLIB NAME)
+     * @param order - 0-based vertex ids in visiting order
+     * @param distance - tour cost
+     */
+    static void writeTour(const string& file_path, TOUR_FORMAT format, const string& name, const vector<int>& order, double distance);
+
+private:
+    static constexpr size_t BUFFER_SIZE = 1 << 20; /**< Bytes formatted before each write >**/
+};
+
+
+#endif //TSP_ANALYSIS_TOURWRITER_H
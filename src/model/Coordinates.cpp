@@ -24,6 +24,21 @@
     }
 }
 
+Coordinate* Coordinate::planar(double x, double y) {
+    auto* coordinate = new Coordinate();
+    coordinate->latitude = x;
+    coordinate->longitude = y;
+    return coordinate;
+}
+
+double Coordinate::getX() const {
+    return latitude;
+}
+
+double Coordinate::getY() const {
+    return longitude;
+}
+
 double Coordinate::getLatitude() const {
     return latitude;
 }
@@ -20,6 +20,27 @@ public:
      */
     Coordinate(double latitude, double longitude);
 
+    /**
+     * @brief Builds a coordinate without the latitude/longitude range checks
+     * @note Used for planar datasets (TSPLIB EUC_2D, ATT, ...), where x is kept in latitude and y in longitude
+     * @param x
+     * @param y
+     * @return pointer to the new coordinate
+     */
+    static Coordinate* planar(double x, double y);
+
+    /**
+     * @brief This method returns the x value of a planar coordinate (same field as latitude)
+     * @return x
+     */
+    [[nodiscard]] double getX() const;
+
+    /**
+     * @brief This method returns the y value of a planar coordinate (same field as longitude)
+     * @return y
+     */
+    [[nodiscard]] double getY() const;
+
     /**
      * @brief This method returns the latitude (-90 to 90 degrees inclusive)
      * @return latitude
@@ -45,6 +66,8 @@ public:
     void setLongitude(double longitude);
 
 private:
+    Coordinate() = default;
+
     double latitude; /**< Latitude field >**/
     double longitude; /**< Longitude field >**/
 };
@@ -0,0 +1,146 @@
+/**
+* @file DistanceMatrix.cpp
+* @brief This file contains the implementation of DistanceMatrix.
+*/
+
+/**< Project headers >**/
+#include "DistanceMatrix.h"
+#include "../Exceptions/CustomError.h"
+
+/**< STD headers >**/
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+DistanceMatrix::DistanceMatrix(const Graph* graph, Vertex* start, bool use_metric) {
+    if (graph == nullptr || start == nullptr) {
+        throw CustomError("NullPtr: graph/start is a null ptr", ERROR);
+    }
+    // Start first, then the vertex set order
+    vertices.push_back(start);
+    for (Vertex* v : graph->getVertexSet()) {
+        if (v != start) {
+            vertices.push_back(v);
+        }
+    }
+    n = static_cast<int>(vertices.size());
+    distances.assign(static_cast<size_t>(n) * n, INF);
+
+    unordered_map<const Vertex*, int> index;
+    for (int i = 0; i < n; i++) {
+        index[vertices[i]] = i;
+    }
+
+    const Metric* metric = graph->getMetric();
+    for (int i = 0; i < n; i++) {
+        double* r = distances.data() + static_cast<size_t>(i) * n;
+        r[i] = 0;
+        for (const Edge* e : vertices[i]->getAdj()) {
+            auto it = index.find(e->getDestination());
+            if (it != index.end() && it->second != i) {
+                r[it->second] = e->getDistance();
+            }
+        }
+        if (use_metric) {
+            for (int j = 0; j < n; j++) {
+                if (r[j] == INF && metric->canMeasure(vertices[i], vertices[j])) {
+                    r[j] = metric->distance(vertices[i], vertices[j]);
+                }
+            }
+        }
+    }
+}
+
+bool DistanceMatrix::isIntegral() const {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            double d = get(i, j);
+            if (i != j && d != INF && (d != floor(d) || d < 0)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool DistanceMatrix::isSymmetric() const {
+    // Compared in tiles, so that the column side of a tile stays in cache
+    const int TILE = 64;
+    for (int bi = 0; bi < n; bi += TILE) {
+        for (int bj = bi; bj < n; bj += TILE) {
+            for (int i = bi; i < min(bi + TILE, n); i++) {
+                for (int j = max(bj, i + 1); j < min(bj + TILE, n); j++) {
+                    if (get(i, j) != get(j, i)) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+double DistanceMatrix::getMaxDistance() const {
+    double max_distance = 0;
+    for (double d : distances) {
+        if (d != INF && d > max_distance) {
+            max_distance = d;
+        }
+    }
+    return max_distance;
+}
+
+uint64_t DistanceMatrix::getChecksum() const {
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&hash](const void* data, size_t bytes) {
+        const auto* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < bytes; i++) {
+            hash = (hash ^ p[i]) * 1099511628211ULL;
+        }
+    };
+    add(&n, sizeof(n));
+    add(distances.data(), distances.size() * sizeof(double));
+    return hash;
+}
+
+double DistanceMatrix::tourCost(const vector<int>& order) const {
+    if (order.empty()) {
+        return INF;
+    }
+    double cost = 0;
+    for (size_t i = 0; i < order.size(); i++) {
+        cost += get(order[i], order[(i + 1) % order.size()]);
+    }
+    return cost;
+}
+
+bool DistanceMatrix::isDominated(const int* path, int length, int next, bool symmetric) const {
+    if (length < 3) {
+        return false;
+    }
+    // Small relative tolerance so that rounding never drops an optimal path
+    const double tolerance = 1e-9;
+    int last = path[length - 1];
+    int before = path[length - 2];
+    double new_edge = get(last, next);
+    double move_gain = get(before, last) + new_edge - get(before, next);
+
+    for (int i = 0; i + 2 < length; i++) {
+        int a = path[i];
+        int b = path[i + 1];
+        double old_edge = get(a, b);
+        // 2-opt: a -> b ... last -> next becomes a -> last ... b -> next
+        if (symmetric) {
+            double removed = old_edge + new_edge;
+            if (get(a, last) + get(b, next) < removed - tolerance * removed) {
+                return true;
+            }
+        }
+        // Or-opt: last moves between a and b, before -> next is used instead
+        double inserted = get(a, last) + get(last, b) - old_edge;
+        if (inserted < move_gain - tolerance * (old_edge + abs(move_gain))) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,121 @@
+#ifndef TSP_ANALYSIS_DISTANCEMATRIX_H
+#define TSP_ANALYSIS_DISTANCEMATRIX_H
+
+/**
+* @file DistanceMatrix.h
+* @brief This file contains the DistanceMatrix header.
+*/
+
+/**< Project headers >**/
+#include "Graph.h"
+
+/**< STD headers >**/
+#include <cstdint>
+#include <limits>
+#include <vector>
+using namespace std;
+
+/**
+ * @class DistanceMatrix
+ * @brief Dense n x n copy of the graph distances used by the exact solvers.
+ *
+ * Index 0 is always the start vertex, the others follow the vertex set order. An entry is the edge distance if the edge
+ * exists, else the graph metric distance if it can be measured (same fallback as backtracking), else infinity.
+ */
+class DistanceMatrix {
+public:
+    /**
+     * @constructor DistanceMatrix
+     * @Complexity - O(V^2 + E)
+     * @param graph - graph to copy
+     * @param start - start vertex (index 0)
+     * @param use_metric - fill missing edges with the graph metric
+     */
+    DistanceMatrix(const Graph* graph, Vertex* start, bool use_metric = true);
+
+    /**
+     * @brief Number of vertices
+     * @return n
+     */
+    [[nodiscard]] int size() const { return n; }
+
+    /**
+     * @brief Distance from i to j (infinity if there is no way to go from i to j)
+     * @param i - origin index
+     * @param j - destination index
+     * @return distance
+     */
+    [[nodiscard]] double get(int i, int j) const { return distances[static_cast<size_t>(i) * n + j]; }
+
+    /**
+     * @brief Row of distances from i
+     * @param i - origin index
+     * @return pointer to n distances
+     */
+    [[nodiscard]] const double* row(int i) const { return distances.data() + static_cast<size_t>(i) * n; }
+
+    /**
+     * @brief Vertex of an index
+     * @param i - index
+     * @return pointer to vertex
+     */
+    [[nodiscard]] Vertex* getVertex(int i) const { return vertices[i]; }
+
+    /**
+     * @brief Checks if every finite entry outside the diagonal is a non negative integer
+     * @return true if the distances can be summed exactly in integers
+     */
+    [[nodiscard]] bool isIntegral() const;
+
+    /**
+     * @brief Checks if d(i, j) == d(j, i) for every pair
+     * @return true if symmetric
+     */
+    [[nodiscard]] bool isSymmetric() const;
+
+    /**
+     * @brief Largest finite distance
+     * @return max distance, 0 if there is none
+     */
+    [[nodiscard]] double getMaxDistance() const;
+
+    /**
+     * @brief FNV-1a hash of the size and the distances, tells if a saved search belongs to this matrix
+     * @Complexity - O(V^2)
+     * @return checksum
+     */
+    [[nodiscard]] uint64_t getChecksum() const;
+
+    /**
+     * @brief Cost of a closed tour given as indices (the edge back to the first index is included)
+     * @param order - indices in visiting order
+     * @return tour cost, infinity if an edge is missing
+     */
+    [[nodiscard]] double tourCost(const vector<int>& order) const;
+
+    /**
+     * @brief Checks if appending next to a path gives a path that a local move makes strictly cheaper with the same
+     * vertices and the same ends, such a path is never the start of an optimal tour.
+     *
+     * Moves tested: 2-opt between the new edge and an earlier edge (symmetric only, it reverses a segment) and Or-opt
+     * of the vertex before next into an earlier edge.
+     *
+     * @Complexity - O(length)
+     * @param path - indices of the path
+     * @param length - vertices in the path
+     * @param next - index appended to the path
+     * @param symmetric - the matrix is symmetric
+     * @return true if the path is dominated
+     */
+    [[nodiscard]] bool isDominated(const int* path, int length, int next, bool symmetric) const;
+
+    static constexpr double INF = numeric_limits<double>::infinity(); /**< Missing edge >**/
+
+private:
+    int n; /**< Number of vertices >**/
+    vector<double> distances; /**< Row major distances >**/
+    vector<Vertex*> vertices; /**< Vertex of each index >**/
+};
+
+
+#endif //TSP_ANALYSIS_DISTANCEMATRIX_H
@@ -11,6 +11,7 @@ Graph::~Graph() {
         auto it = vertexSet.begin();
         removeVertex(*it);
     }
+    delete metric;
 }
 
 bool Graph::addVertex(Vertex *v) {
@@ -76,3 +77,13 @@ Edge *Graph::getEdgeFromGraph(Vertex *origin, Vertex *destination) {
 }
 
 
+Metric* Graph::getMetric() const {
+    return metric;
+}
+
+void Graph::setMetric(Metric* _metric) {
+    if (_metric != nullptr && _metric != metric) {
+        delete metric;
+        metric = _metric;
+    }
+}
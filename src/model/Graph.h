@@ -9,6 +9,7 @@
 /**< Project headers >**/
 #include "Edge.h"
 #include "Vertex.h"
+#include "Metric.h"
 
 /**< STD headers >**/
 #include <string>
@@ -79,10 +80,23 @@ public:
 
     Edge* getEdgeFromGraph(Vertex* origin, Vertex* destination);
 
+    /**
+     * @brief Get the metric used for distances between vertices without an edge
+     * @return pointer to metric
+     */
+    [[nodiscard]] Metric* getMetric() const;
+
+    /**
+     * @brief Set a new metric, the graph takes ownership and deletes the old one
+     * @param metric
+     */
+    void setMetric(Metric* metric);
+
 
 private:
     vector<Vertex*> vertexSet; /**< Vector containing pointers to the vertices of the graph. */
     int n = 0; /**< The number of vertices in the graph. */
+    Metric* metric = new Metric(); /**< On-demand distances, haversine by default. */
 
 };
 #endif //TSP_ANALYSIS_GRAPH_H
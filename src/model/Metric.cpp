@@ -0,0 +1,127 @@
+/**
+* @file Metric.cpp
+* @brief This file contains the implementation of Metric.
+*/
+
+/**< Project headers >**/
+#include "Metric.h"
+#include "Vertex.h"
+#include "../Exceptions/CustomError.h"
+
+/**< STD headers >**/
+#include <cmath>
+
+Metric::Metric(WEIGHT_TYPE type) {
+    this->type = type;
+}
+
+WEIGHT_TYPE Metric::getType() const {
+    return this->type;
+}
+
+void Metric::setExplicitMatrix(vector<double> _matrix, int _dimension) {
+    if (_matrix.size() != static_cast<size_t>(_dimension) * _dimension) {
+        throw CustomError("Explicit matrix size does not match the dimension", ERROR);
+    }
+    this->matrix = std::move(_matrix);
+    this->dimension = _dimension;
+}
+
+size_t Metric::getMemoryUsage() const {
+    return matrix.capacity() * sizeof(double);
+}
+
+bool Metric::canMeasure(const Vertex* origin, const Vertex* destination) const {
+    if (origin == nullptr || destination == nullptr) {
+        return false;
+    }
+    if (type == EXPLICIT) {
+        return origin->getId() >= 0 && origin->getId() < dimension &&
+               destination->getId() >= 0 && destination->getId() < dimension;
+    }
+    return origin->getCoordinates() != nullptr && destination->getCoordinates() != nullptr;
+}
+
+/**
+ * @note TSPLIB GEO coordinates are DDD.MM (degrees and minutes)
+ */
+static double geoRadians(double x) {
+    const double PI = 3.141592;
+    double deg = trunc(x);
+    double min = x - deg;
+    return PI * (deg + 5.0 * min / 3.0) / 180.0;
+}
+
+double Metric::distance(const Vertex* origin, const Vertex* destination) const {
+    if (!canMeasure(origin, destination)) {
+        throw CustomError("Metric error - distance between vertices can't be measured", ERROR);
+    }
+    if (type == EXPLICIT) {
+        return matrix[static_cast<size_t>(origin->getId()) * dimension + destination->getId()];
+    }
+
+    const Coordinate* o = origin->getCoordinates();
+    const Coordinate* d = destination->getCoordinates();
+    switch (type) {
+        case HAVERSINE: {
+            double delta_lat = (d->getLatitude() - o->getLatitude()) * M_PI / 180;
+            double delta_lon = (d->getLongitude() - o->getLongitude()) * M_PI / 180;
+            double a = pow(sin(delta_lat / 2), 2) +
+                       pow(sin(delta_lon / 2), 2) * cos(o->getLatitude() * M_PI / 180) *
+                       cos(d->getLatitude() * M_PI / 180);
+            double c = 2 * asin(sqrt(a));
+            return 6371.0 * c * 1000;
+        }
+        case EUC_2D: {
+            double dx = o->getX() - d->getX();
+            double dy = o->getY() - d->getY();
+            return floor(sqrt(dx * dx + dy * dy) + 0.5);
+        }
+        case CEIL_2D: {
+            double dx = o->getX() - d->getX();
+            double dy = o->getY() - d->getY();
+            return ceil(sqrt(dx * dx + dy * dy));
+        }
+        case ATT: {
+            double dx = o->getX() - d->getX();
+            double dy = o->getY() - d->getY();
+            double r = sqrt((dx * dx + dy * dy) / 10.0);
+            double t = floor(r + 0.5);
+            return (t < r) ? t + 1 : t;
+        }
+        case GEO: {
+            const double RRR = 6378.388;
+            double lat_o = geoRadians(o->getX()), lon_o = geoRadians(o->getY());
+            double lat_d = geoRadians(d->getX()), lon_d = geoRadians(d->getY());
+            double q1 = cos(lon_o - lon_d);
+            double q2 = cos(lat_o - lat_d);
+            double q3 = cos(lat_o + lat_d);
+            return static_cast<int>(RRR * acos(0.5 * ((1.0 + q1) * q2 - (1.0 - q1) * q3)) + 1.0);
+        }
+        default:
+            throw CustomError("Metric error - unknown weight type", ERROR);
+    }
+}
+
+bool Metric::getPoint(const Vertex* vertex, double* point) const {
+    if (vertex == nullptr || vertex->getCoordinates() == nullptr || type == EXPLICIT) {
+        return false;
+    }
+    const Coordinate* c = vertex->getCoordinates();
+    switch (type) {
+        case HAVERSINE:
+        case GEO: {
+            double lat = (type == GEO) ? geoRadians(c->getX()) : c->getLatitude() * M_PI / 180;
+            double lon = (type == GEO) ? geoRadians(c->getY()) : c->getLongitude() * M_PI / 180;
+            point[0] = cos(lat) * cos(lon);
+            point[1] = cos(lat) * sin(lon);
+            point[2] = sin(lat);
+            return true;
+        }
+        default:
+            point[0] = c->getX();
+            point[1] = c->getY();
+            point[2] = 0;
+            return true;
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef TSP_ANALYSIS_METRIC_H
+#define TSP_ANALYSIS_METRIC_H
+
+/**
+* @file Metric.h
+* @brief This file contains the Metric header.
+*/
+
+/**< STD headers >**/
+#include <vector>
+using namespace std;
+
+class Vertex;
+
+/**
+ * @brief Edge weight types, named after the TSPLIB EDGE_WEIGHT_TYPE keywords
+ */
+enum WEIGHT_TYPE{
+    HAVERSINE, /**< Geographic coordinates in degrees (project csv datasets) >**/
+    EUC_2D,    /**< Euclidean distance rounded to the nearest integer >**/
+    CEIL_2D,   /**< Euclidean distance rounded up >**/
+    GEO,       /**< TSPLIB geographical distance (DDD.MM coordinates) >**/
+    ATT,       /**< TSPLIB pseudo-euclidean distance >**/
+    EXPLICIT   /**< Distances given by a matrix in the file >**/
+};
+
+/**
+ * @class Metric
+ * @brief Computes on-demand distances between two vertices that are not connected by an edge.
+ *
+ * Coordinate based instances are not materialized as O(n^2) edges, the algorithms ask the metric instead.
+ */
+class Metric {
+public:
+    /**
+     * @constructor Metric
+     * @param type - weight type of the graph
+     */
+    explicit Metric(WEIGHT_TYPE type = HAVERSINE);
+
+    /**
+     * @brief Get the weight type
+     * @return type
+     */
+    [[nodiscard]] WEIGHT_TYPE getType() const;
+
+    /**
+     * @brief Set the explicit distance matrix (row major, indexed by vertex id)
+     * @param matrix - dimension * dimension distances
+     * @param dimension - number of vertices
+     */
+    void setExplicitMatrix(vector<double> matrix, int dimension);
+
+    /**
+     * @brief Bytes used by the explicit matrix
+     * @return memory usage
+     */
+    [[nodiscard]] size_t getMemoryUsage() const;
+
+    /**
+     * @brief Checks if the distance between two vertices can be computed without an edge
+     * @Complexity - O(1)
+     * @param origin
+     * @param destination
+     * @return true if measurable else false
+     */
+    [[nodiscard]] bool canMeasure(const Vertex* origin, const Vertex* destination) const;
+
+    /**
+     * @brief Distance between two vertices
+     * @Complexity - O(1)
+     * @param origin
+     * @param destination
+     * @return distance (meters for haversine, TSPLIB units for the others)
+     */
+    [[nodiscard]] double distance(const Vertex* origin, const Vertex* destination) const;
+
+    /**
+     * @brief Point in space whose euclidean distances are ordered like the distances of the metric (unit sphere for
+     * geographic coordinates, the plane z = 0 otherwise), so that nearest neighbours can be searched geometrically
+     * @Complexity - O(1)
+     * @param vertex
+     * @param point - x, y, z
+     * @return false if the vertex has no coordinates or the distances are explicit
+     */
+    bool getPoint(const Vertex* vertex, double* point) const;
+
+private:
+    WEIGHT_TYPE type; /**< Weight type >**/
+    vector<double> matrix; /**< Explicit matrix, only used for EXPLICIT >**/
+    int dimension = 0; /**< Dimension of the explicit matrix >**/
+};
+
+
+#endif //TSP_ANALYSIS_METRIC_H
@@ -5,7 +5,12 @@
 */
 // Project headers
 #include "Menu.h"
+#include "../controller/TourWriter.h"
+#include "../controller/DecompressStream.h"
 // Standard Library Headers
+#include <algorithm>
+#include <limits>
+#include <numeric>
 #include <sstream>
 #include <filesystem>
 
@@ -20,6 +25,16 @@ Menu::Menu(Manager* manager) {
     }
     this->manager = manager;
     this->mode = false; // Default mode : Real World
+
+    // Long exact searches show the incumbent and the bound while they run
+    manager->getCoder()->setProgress([](const SearchProgress& p) {
+        cout << "Time: " << p.elapsed << "s Nodes: " << p.nodes << " (" << static_cast<long long>(p.rate) << "/s) Open: "
+             << p.open << " Incumbent: " << p.incumbent << " Bound: " << p.bound;
+        if (p.incumbent != DistanceMatrix::INF && p.incumbent > 0) {
+            cout << " Gap: " << (p.incumbent - p.bound) / p.incumbent * 100 << '%';
+        }
+        cout << endl;
+    });
 }
 
 /* Auxiliary functions */
@@ -164,22 +179,177 @@ void Menu::getVertexExamples(){
 /** Results functions **/
 
 void Menu::displayResult(const Result& r){
+    last_tour = TourWriter::getVertexOrder(r);
+    last_distance = r.distance;
     if (r.tour.empty()) {
         cout << "No solution was found" << endl;
     }
     else {
-        for (Edge *e: r.tour) {
-            if (e == nullptr) {
-                throw CustomError("NullPtr: edge e is null ptr", ERROR);
+        if (summary_mode) {
+            cout << "Tour with " << r.tour.size() << " edges starting at " << r.tour.front()->getOrigin()->getLabel()
+                 << " (summary mode, export the tour to see it)" << '\n';
+        }
+        else {
+            // One write for the whole tour instead of a flush per edge
+            string lines;
+            lines.reserve(r.tour.size() * 16);
+            for (Edge *e: r.tour) {
+                if (e == nullptr) {
+                    throw CustomError("NullPtr: edge e is null ptr", ERROR);
+                }
+                lines += e->getOrigin()->getLabel();
+                lines += "-> ";
+                lines += e->getDestination()->getLabel();
+                lines += '\n';
             }
-            cout << e->getOrigin()->getLabel() << "-> " << e->getDestination()->getLabel() << endl;
+            cout.write(lines.data(), static_cast<streamsize>(lines.size()));
         }
 
-        cout << "Distance: " << r.distance << endl;
+        cout << "Distance: " << r.distance << '\n';
+        if (r.stopped) {
+            cout << "Stopped at the time limit, optimum is at least " << r.lower_bound;
+            if (r.distance > 0) {
+                cout << " (gap " << (r.distance - r.lower_bound) / r.distance * 100 << "%)";
+            }
+            cout << '\n';
+        }
+        if (r.nodes > 0) {
+            cout << "Nodes expanded: " << r.nodes << '\n';
+        }
+        if (!r.start_costs.empty()) {
+            vector<double> costs;
+            for (const auto& start : r.start_costs) {
+                if (start.second != numeric_limits<double>::infinity()) {
+                    costs.push_back(start.second);
+                }
+            }
+            sort(costs.begin(), costs.end());
+            double mean = accumulate(costs.begin(), costs.end(), 0.0) / static_cast<double>(costs.size());
+            cout << "Starts tried: " << r.start_costs.size() << " (" << r.start_costs.size() - costs.size()
+                 << " without a tour)" << '\n';
+            cout << "Cost from the starts: min " << costs.front() << " median " << costs[costs.size() / 2] << " mean "
+                 << mean << " max " << costs.back() << '\n';
+        }
+        if (r.thread_nodes.size() > 1) {
+            cout << "Nodes per thread:";
+            for (unsigned long long nodes : r.thread_nodes) {
+                cout << ' ' << nodes;
+            }
+            cout << '\n';
+        }
         cout << "CPU Time: " << r.time_spent.elapsed_cpu << " Real Time: " << r.time_spent.elapsed_real << endl;
     }
 }
 
+void Menu::exportLastTour() {
+    if (last_tour.empty()) {
+        cout << "There is no tour to export" << endl;
+        return;
+    }
+    int option = 0;
+    do {
+        cout << "Export format: 1. Vertex order csv  2. TSPLIB .tour  3. Binary" << endl;
+    } while (!getNumberInput(&option, 3, 1));
+    TOUR_FORMAT format = (option == 1) ? CSV_ORDER : (option == 2) ? TSPLIB_TOUR : BINARY;
+
+    cout << "Enter the output file path ('-' for the terminal): ";
+    string path;
+    getline(cin, path);
+    path = removeLeadingTrailingSpaces(path);
+    if (path.empty()) {
+        cout << "Invalid path" << endl;
+        return;
+    }
+    string name = (path == "-") ? "tour" : filesystem::path(path).stem().string();
+    try {
+        TourWriter::writeTour(path, format, name, last_tour, last_distance);
+    }
+    catch (const CustomError& e) {
+        e.what();
+        return;
+    }
+    if (path != "-") {
+        cout << "Tour exported to " << path << endl;
+    }
+}
+
+void Menu::searchSettings() {
+    Coder* coder = manager->getCoder();
+    cout << "Time limit in seconds (0 for none, now " << coder->getTimeLimit() << "): ";
+    string input;
+    getline(cin, input);
+    try {
+        double seconds = stod(input);
+        if (seconds < 0) {
+            throw invalid_argument("negative");
+        }
+        coder->setTimeLimit(seconds);
+    }
+    catch (const exception&) {
+        cout << "Invalid time limit, kept " << coder->getTimeLimit() << endl;
+    }
+
+    cout << "Checkpoint file ('-' for none, now " << (coder->getCheckpoint().empty() ? "-" : coder->getCheckpoint())
+         << "): ";
+    getline(cin, input);
+    input = removeLeadingTrailingSpaces(input);
+    if (!input.empty()) {
+        coder->setCheckpoint(input == "-" ? "" : input);
+    }
+}
+
+BOUND_TYPE Menu::chooseBound() {
+    int option = 0;
+    do {
+        cout << "Lower bound: 1. Two cheapest edges  2. 1-tree  3. Reduced matrix  4. Assignment (directed graphs)" << endl;
+    } while (!getNumberInput(&option, 4, 1));
+    const BOUND_TYPE bounds[] = {TWO_EDGES, ONE_TREE, REDUCED_MATRIX, ASSIGNMENT};
+    return bounds[option - 1];
+}
+
+MATCHING_TYPE Menu::chooseMatching() {
+    int option = 0;
+    do {
+        cout << "Matching: 1. Optimal (blossom, greedy above " << Matching::OPTIMAL_MAX_SIZE << " odd vertices)  2. Greedy (large graphs)" << endl;
+    } while (!getNumberInput(&option, 2, 1));
+    return (option == 1) ? OPTIMAL_MATCHING : GREEDY_MATCHING;
+}
+
+INSERTION_TYPE Menu::chooseInsertion() {
+    int option = 0;
+    do {
+        cout << "Insertion: 1. Nearest  2. Farthest  3. Cheapest  4. Convex hull (coordinates only)" << endl;
+    } while (!getNumberInput(&option, 4, 1));
+    const INSERTION_TYPE types[] = {NEAREST_INSERTION, FARTHEST_INSERTION, CHEAPEST_INSERTION, CONVEX_HULL_INSERTION};
+    return types[option - 1];
+}
+
+CONSTRUCTION_TYPE Menu::chooseConstruction() {
+    int option = 0;
+    do {
+        cout << "Construction: 1. Nearest neighbor  2. Real world  3. Triangular approximation" << endl;
+    } while (!getNumberInput(&option, 3, 1));
+    const CONSTRUCTION_TYPE types[] = {NEAREST_NEIGHBOR_CONSTRUCTION, REAL_WORLD_CONSTRUCTION, TRIANGULAR_CONSTRUCTION};
+    return types[option - 1];
+}
+
+int Menu::chooseStarts() {
+    cout << "Number of start vertices to try (0 for every vertex): ";
+    string input;
+    getline(cin, input);
+    try {
+        int starts = stoi(input);
+        if (starts < 0) {
+            throw invalid_argument("negative");
+        }
+        return starts;
+    }
+    catch (const exception&) {
+        cout << "Invalid number, trying every vertex" << endl;
+        return 0;
+    }
+}
+
 /** Menus **/
 
 void Menu::mainMenu() {
@@ -225,10 +395,11 @@ void Menu::dataSetMenu() {
         cout << "             2. Choose medium data set          " << endl;
         cout << "             3. Choose Real-World data set      " << endl;
         cout << "             4. Choose your own data set        " << endl;
-        cout << "             5. Go back                         " << endl;
+        cout << "             5. Choose TSPLIB instance          " << endl;
+        cout << "             6. Go back                         " << endl;
         cout << "                                                " << endl;
         cout << "------------------------------------------------" << endl;
-    } while (!getNumberInput(&option,5,1));
+    } while (!getNumberInput(&option,6,1));
 
     switch (option) {
         case 1:
@@ -248,6 +419,10 @@ void Menu::dataSetMenu() {
             yourDataSetMenu();
             break;
         case 5:
+            menuStack.push(&Menu::dataSetMenu);
+            tsplibMenu();
+            break;
+        case 6:
             goBack();
             break;
         default:
@@ -305,6 +480,43 @@ void Menu::yourDataSetMenu(){
     }
 }
 
+void Menu::tsplibMenu(){
+    int option = 0;
+    Folder f;
+    do {
+        cout << "------------------------------------------------" << endl;
+        cout << "         Menu -> Choose TSPLIB instance         " << endl;
+        f.clear();
+        Folder files = filesystem::is_directory("../data/TSPLIB") ? getFolderContents("../data/TSPLIB") : Folder();
+        for (const auto& file : files){
+            filesystem::path name = filesystem::path(file);
+            if (DecompressStream::getCompression(file) != NONE){
+                name = name.stem(); // instance.tsp.gz -> instance.tsp
+            }
+            string extension = name.extension().string();
+            if (extension == ".tsp" || extension == ".atsp"){
+                f.push_back(file);
+            }
+        }
+        int count = 1;
+        for (const auto& file: f){
+            cout << "            " << count << ". " << filesystem::path(file).filename().string() << "        " << endl;
+            count++;
+        }
+        cout << "            " << count << ". Go back" << "         " << endl;
+        cout << "------------------------------------------------" << endl;
+    }
+    while(!getNumberInput(&option,static_cast<int>(f.size() + 1),1));
+
+    if (option == static_cast<int>(f.size() + 1)){
+        goBack();
+    }
+    else{
+        manager->callParserImportTSPLIB(f[option - 1]);
+        menuStack.push(&Menu::tsplibMenu);
+        algorithmMenu();
+    }
+}
 
 void Menu::toyMenu(){
     int option = 0;
@@ -366,10 +578,11 @@ void Menu::mediumMenu(){
         cout << "             10. Choose 700 edges               " << endl;
         cout << "             11. Choose 800 edges               " << endl;
         cout << "             12. Choose 900 edges               " << endl;
-        cout << "             13. Go back                        " << endl;
+        cout << "             13. Sweep all medium graphs        " << endl;
+        cout << "             14. Go back                        " << endl;
         cout << "                                                " << endl;
         cout << "------------------------------------------------" << endl;
-    } while (!getNumberInput(&option,13,1));
+    } while (!getNumberInput(&option,14,1));
 
     switch (option) {
         case 1:
@@ -454,6 +667,10 @@ void Menu::mediumMenu(){
             algorithmMenu();
             break;
         case 13:
+            sweepMediumGraphs();
+            mediumMenu();
+            break;
+        case 14:
             goBack();
             break;
         default:
@@ -461,6 +678,34 @@ void Menu::mediumMenu(){
     }
 }
 
+void Menu::sweepMediumGraphs() {
+    int option = 0;
+    do {
+        cout << "Sweep algorithm: 1. Triangular Approximation  2. Nearest Neighbor  3. TSP in real World" << endl;
+    } while (!getNumberInput(&option, 3, 1));
+
+    vector<DatasetSource> sources;
+    for (int n : {25, 50, 75, 100, 200, 300, 400, 500, 600, 700, 800, 900}) {
+        sources.push_back({"../data/Extra_Fully_Connected_Graphs/nodes.csv", n,
+                           "../data/Extra_Fully_Connected_Graphs/edges_" + to_string(n) + ".csv", static_cast<bool>(mode), false});
+    }
+
+    // The next graph is imported in the background while the algorithm runs on the current one
+    manager->sweep(sources, [&](const DatasetSource& source) {
+        Coder* coder = manager->getCoder();
+        Result r = (option == 1) ? coder->triangularApproximation() :
+                   (option == 2) ? coder->nearestNeighbor() : coder->realWorld();
+        cout << source.number_of_vertices << " vertices -> ";
+        if (r.tour.empty()) {
+            cout << "No solution was found" << '\n';
+        }
+        else {
+            cout << "Distance: " << r.distance << " CPU Time: " << r.time_spent.elapsed_cpu
+                 << " Real Time: " << r.time_spent.elapsed_real << '\n';
+        }
+    });
+    cout << flush;
+}
 
 void Menu::realWorldMenu(){
     int option = 0;
@@ -522,15 +767,20 @@ void Menu::algorithmMenu() {
         cout << "         2. Triangular Approximation - Prim   " << endl;
         cout << "         3. Other Heuristic (Nearest Neighbor) " << endl;
         cout << "         4. TSP in real World                  " << endl;
+        cout << "         5. Christofides                       " << endl;
+        cout << "         6. Greedy Edge (Multi-fragment)       " << endl;
+        cout << "         7. Hilbert Curve (Coordinates only)   " << endl;
+        cout << "         8. Insertion Heuristics               " << endl;
+        cout << "         9. Multi-start Construction           " << endl;
         cout << "                                               " << endl;
         cout << "          Extra Algorithms and Metrics        " << endl;
         cout << "                                              " << endl;
-        cout << "                   5. Extra                   " << endl;
+        cout << "                   10. Extra                  " << endl;
         cout << "                                              " << endl;
         cout << "               Go back option                 " << endl;
-        cout << "                 6. Go back                   " << endl;
+        cout << "                 11. Go back                  " << endl;
         cout << "----------------------------------------------" << endl;
-    } while (!getNumberInput(&option,6,1));
+    } while (!getNumberInput(&option,11,1));
     Result r;
     int vertex_chosen;
 
@@ -593,10 +843,57 @@ void Menu::algorithmMenu() {
             }
             break;
         case 5:
+            chooseVertex(vertex_chosen);
+            if (vertex_chosen == -1) {
+                algorithmMenu();
+            } else {
+                r = manager->getCoder()->christofides(vertex_chosen, chooseMatching());
+                displayResult(r);
+                algorithmMenu();
+            }
+            break;
+        case 6:
+            chooseVertex(vertex_chosen);
+            if (vertex_chosen == -1) {
+                algorithmMenu();
+            } else {
+                r = manager->getCoder()->greedyEdge(vertex_chosen);
+                displayResult(r);
+                algorithmMenu();
+            }
+            break;
+        case 7:
+            chooseVertex(vertex_chosen);
+            if (vertex_chosen == -1) {
+                algorithmMenu();
+            } else {
+                r = manager->getCoder()->hilbertCurve(vertex_chosen);
+                displayResult(r);
+                algorithmMenu();
+            }
+            break;
+        case 8:
+            chooseVertex(vertex_chosen);
+            if (vertex_chosen == -1) {
+                algorithmMenu();
+            } else {
+                r = manager->getCoder()->insertion(vertex_chosen, chooseInsertion());
+                displayResult(r);
+                algorithmMenu();
+            }
+            break;
+        case 9: {
+            CONSTRUCTION_TYPE construction = chooseConstruction();
+            r = manager->getCoder()->multiStart(construction, chooseStarts());
+            displayResult(r);
+            algorithmMenu();
+            break;
+        }
+        case 10:
             menuStack.push(&Menu::algorithmMenu);
             extraMenu();
             break;
-        case 6:
+        case 11:
             goBack();
             break;
         default:
@@ -613,10 +910,17 @@ void Menu::extraMenu() {
         cout << "              Menu -> Extra algorithm         " << endl;
         cout << "                                              " << endl;
         cout << "              1. Branch and bound             " << endl;
-        cout << "              2. Go back                      " << endl;
+        cout << "              2. Parallel branch and bound    " << endl;
+        cout << "              3. Best-first branch and bound  " << endl;
+        cout << "              4. Held-Karp (parallel exact DP)" << endl;
+        cout << "              5. Exact (solver chosen by size)" << endl;
+        cout << "              6. Export last tour             " << endl;
+        cout << "              7. Summary mode: " << (summary_mode ? "ON " : "OFF") << "            " << endl;
+        cout << "              8. Time limit / checkpoint      " << endl;
+        cout << "              9. Go back                      " << endl;
         cout << "                                              " << endl;
         cout << "----------------------------------------------" << endl;
-    } while (!getNumberInput(&option,2,1));
+    } while (!getNumberInput(&option,9,1));
     Result r;
     int vertex_chosen;
 
@@ -625,17 +929,67 @@ void Menu::extraMenu() {
             chooseVertex(vertex_chosen);
             if (vertex_chosen == -1) {
                 extraMenu();
-            } else if (vertex_chosen == 0) {
-                r = manager->getCoder()->branchBound();
+            } else {
+                r = manager->getCoder()->branchBound(vertex_chosen, chooseBound());
                 displayResult(r);
                 extraMenu();
+            }
+            break;
+        case 2:
+            chooseVertex(vertex_chosen);
+            if (vertex_chosen == -1) {
+                extraMenu();
             } else {
-                r = manager->getCoder()->branchBound(vertex_chosen);
+                r = manager->getCoder()->parallelBranchBound(vertex_chosen, chooseBound());
                 displayResult(r);
                 extraMenu();
             }
             break;
-        case 2:
+        case 3:
+            chooseVertex(vertex_chosen);
+            if (vertex_chosen == -1) {
+                extraMenu();
+            } else {
+                r = manager->getCoder()->bestFirstBranchBound(vertex_chosen, chooseBound());
+                displayResult(r);
+                extraMenu();
+            }
+            break;
+        case 4:
+            cout << "Held-Karp needs about " << (manager->getCoder()->graphHeldKarpMemory() >> 20)
+                 << " MiB (limit " << (manager->getCoder()->getMemoryLimit() >> 20) << " MiB)" << endl;
+            chooseVertex(vertex_chosen);
+            if (vertex_chosen == -1) {
+                extraMenu();
+            } else {
+                r = manager->getCoder()->parallelHeldKarp(vertex_chosen);
+                displayResult(r);
+                extraMenu();
+            }
+            break;
+        case 5:
+            chooseVertex(vertex_chosen);
+            if (vertex_chosen == -1) {
+                extraMenu();
+            } else {
+                r = manager->getCoder()->exactSolve(vertex_chosen);
+                displayResult(r);
+                extraMenu();
+            }
+            break;
+        case 6:
+            exportLastTour();
+            extraMenu();
+            break;
+        case 7:
+            summary_mode = !summary_mode;
+            extraMenu();
+            break;
+        case 8:
+            searchSettings();
+            extraMenu();
+            break;
+        case 9:
             goBack();
             break;
         default:
@@ -66,6 +66,11 @@ public:
     */
      void mediumMenu();
 
+    /**
+     * @brief Run a heuristic on every medium graph, prefetching the next graph while the current one is solved
+     */
+     void sweepMediumGraphs();
+
      /**
       * @brief Choose real world graph
      */
@@ -75,6 +80,11 @@ public:
        */
       void yourDataSetMenu();
 
+      /**
+       * @brief Choose a TSPLIB instance (.tsp/.atsp) from ../data/TSPLIB
+       */
+      void tsplibMenu();
+
     /**
      * @brief Displays the algorithm view.
      */
@@ -93,6 +103,22 @@ private:
     Manager* manager;
     int mode;
 
+    /**
+     * @brief Vertex order (0-based ids) of the last displayed result, used for exports.
+     */
+    vector<int> last_tour;
+
+    /**
+     * @brief Cost of the last displayed result, used for exports.
+     */
+    double last_distance = 0;
+
+    /**
+     * @brief Summary mode: results show only distance and times, the tour itself is exported instead.
+     * @note Used for large instances, where printing the tour costs more than computing it.
+     */
+    bool summary_mode = false;
+
     /**< Auxiliary functions >**/
     /**
     * @brief Removes leading and trailing spaces from a string.
@@ -103,9 +129,50 @@ private:
 
     /**
      * @brief Display Results: including Tour, Time, and ond tour cost
+     * @note The tour is kept as the last tour for exports
      * @param r
      */
-    static void displayResult(const Result& r);
+    void displayResult(const Result& r);
+
+    /**
+     * @brief Export the last displayed tour (vertex order csv, TSPLIB .tour or binary) to a file or stdout
+     */
+    void exportLastTour();
+
+    /**
+     * @brief Ask the time limit and the checkpoint file of the exact searches
+     */
+    void searchSettings();
+
+    /**
+     * @brief Ask which lower bound branch and bound uses
+     * @return bound
+     */
+    static BOUND_TYPE chooseBound();
+
+    /**
+     * @brief Ask which perfect matching Christofides uses
+     * @return matching
+     */
+    static MATCHING_TYPE chooseMatching();
+
+    /**
+     * @brief Ask which rule the insertion heuristics use
+     * @return insertion rule
+     */
+    static INSERTION_TYPE chooseInsertion();
+
+    /**
+     * @brief Ask which construction the multi-start mode runs
+     * @return construction
+     */
+    static CONSTRUCTION_TYPE chooseConstruction();
+
+    /**
+     * @brief Ask how many start vertices the multi-start mode tries
+     * @return number of starts, 0 for every vertex
+     */
+    static int chooseStarts();
 
     /**
      * @bried Used for getting files inside a folder